@@ -0,0 +1,413 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+// =======================================================
+// Allocation + copy/move profiler
+//   theRoleOfMove.cpp and copyReferencePointer.cpp explain copies vs
+//   moves; this counts them in real code, together with heap traffic.
+//
+//   - Every operator new/delete in the program bumps per-thread counters
+//     (allocations, frees, bytes). Define XLAB_ALLOC_PROFILER_MAIN in
+//     exactly one .cpp before the include to install the replacements.
+//   - prof::Tracked<Tag> is an empty member that counts its owner's
+//     copy/move constructions and assignments:
+//         struct Person { std::string name; prof::Tracked<Person> track; };
+//   - prof::Scope attributes everything its thread does between
+//     construction and destruction to a named call site (inclusive of
+//     nested scopes), optionally against a Budget:
+//         prof::Scope s(XLAB_ALLOC_SITE("parse"), {.allocations = 0});
+//         ...
+//         s.check();   // throws prof::BudgetExceeded
+//   - prof::dump(out) prints per-site and per-type totals.
+//
+//   Counting costs two thread-local adds per new/delete plus a 16-byte
+//   header per block (to know the size on unsized delete).
+//   The profiler's own allocations (registering a site, dump, budget
+//   messages) are not counted, so a zero budget holds on the first run too.
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall allocProfilerBench.cpp -pthread
+// =======================================================
+
+namespace prof {
+
+constexpr std::size_t kMaxSites = 256;
+constexpr std::size_t kMaxTypes = 256;
+
+// What one thread did; Scope takes the difference of two snapshots.
+struct Counts {
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t bytes = 0;        // allocated
+    std::uint64_t bytes_freed = 0;
+    std::uint64_t copies = 0;       // copy constructions + copy assignments
+    std::uint64_t moves = 0;        // move constructions + move assignments
+
+    Counts operator-(const Counts& o) const {
+        return {allocations - o.allocations, frees - o.frees, bytes - o.bytes,
+                bytes_freed - o.bytes_freed, copies - o.copies, moves - o.moves};
+    }
+};
+
+// Trivial type, so the thread_local needs no guard or destructor: safe to
+// touch from operator new at any point in a thread's life.
+inline Counts& thread_counts() noexcept {
+    thread_local Counts c;
+    return c;
+}
+
+namespace detail {
+
+// The profiler's own bookkeeping (site registration, dump, budget messages)
+// is not charged to whatever Scope is open: the counts are put back as they
+// were when this guard goes away.
+class Uncounted {
+public:
+    Uncounted() noexcept : saved_(thread_counts()) {}
+    ~Uncounted() { thread_counts() = saved_; }
+    Uncounted(const Uncounted&) = delete;
+    Uncounted& operator=(const Uncounted&) = delete;
+
+private:
+    Counts saved_;
+};
+
+} // namespace detail
+
+// Limits for a Scope; kUnlimited fields are not checked.
+constexpr std::uint64_t kUnlimited = ~std::uint64_t{0};
+
+struct Budget {
+    std::uint64_t allocations = kUnlimited;
+    std::uint64_t bytes = kUnlimited;
+    std::uint64_t copies = kUnlimited;
+    std::uint64_t moves = kUnlimited;
+};
+
+class BudgetExceeded : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// =======================================================
+// Sites (same shape as instrumented::LockSite)
+// =======================================================
+struct AllocSite {
+    std::string name;
+    const char* file = nullptr;
+    int line = 0;
+    std::size_t index = kMaxSites;   // kMaxSites: registry full, not recorded
+};
+
+struct SiteTotals {
+    std::atomic<std::uint64_t> scopes{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> copies{0};
+    std::atomic<std::uint64_t> moves{0};
+    std::atomic<std::uint64_t> over_budget{0};
+};
+
+struct TypeTotals {
+    const std::type_info* type = nullptr;
+    std::atomic<std::uint64_t> copies{0};
+    std::atomic<std::uint64_t> moves{0};
+};
+
+class Registry {
+public:
+    AllocSite& site(std::string_view name, const char* file = nullptr, int line = 0) {
+        detail::Uncounted uncounted;
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& s : sites_) {
+            if (s->name == name && s->file == file && s->line == line) return *s;
+        }
+        sites_.push_back(std::make_unique<AllocSite>(AllocSite{std::string(name), file, line, kMaxSites}));
+        AllocSite& s = *sites_.back();
+        if (sites_.size() <= kMaxSites) s.index = sites_.size() - 1;
+        return s;
+    }
+
+    SiteTotals* totals(const AllocSite& s) noexcept { return s.index < kMaxSites ? &site_totals_[s.index] : nullptr; }
+
+    // One slot per Tracked<Tag> type, claimed on first use.
+    TypeTotals* type(const std::type_info& t) noexcept {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (std::size_t i = 0; i < types_used_; ++i)
+            if (*type_totals_[i].type == t) return &type_totals_[i];
+        if (types_used_ == kMaxTypes) return nullptr;
+        type_totals_[types_used_].type = &t;
+        return &type_totals_[types_used_++];
+    }
+
+    void dump(std::ostream& out);
+
+private:
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<AllocSite>> sites_;
+    SiteTotals site_totals_[kMaxSites];
+    TypeTotals type_totals_[kMaxTypes];
+    std::size_t types_used_ = 0;
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+#define XLAB_ALLOC_SITE(name) \
+    ([]() -> ::prof::AllocSite& { \
+        static ::prof::AllocSite& s = ::prof::registry().site(name, __FILE__, __LINE__); \
+        return s; \
+    }())
+
+// =======================================================
+// Tracked<Tag>: copy/move counter to embed in a value type
+// =======================================================
+template <class Tag>
+class Tracked {
+public:
+    Tracked() noexcept = default;
+    Tracked(const Tracked&) noexcept { on_copy(); }
+    Tracked(Tracked&&) noexcept { on_move(); }
+    Tracked& operator=(const Tracked&) noexcept {
+        on_copy();
+        return *this;
+    }
+    Tracked& operator=(Tracked&&) noexcept {
+        on_move();
+        return *this;
+    }
+
+private:
+    static TypeTotals* totals() noexcept {
+        static TypeTotals* t = registry().type(typeid(Tag));
+        return t;
+    }
+    static void on_copy() noexcept {
+        ++thread_counts().copies;
+        if (auto* t = totals()) t->copies.fetch_add(1, std::memory_order_relaxed);
+    }
+    static void on_move() noexcept {
+        ++thread_counts().moves;
+        if (auto* t = totals()) t->moves.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// =======================================================
+// Scope: RAII attribution to a site, optional budget
+// =======================================================
+class Scope {
+public:
+    explicit Scope(AllocSite& site, Budget budget = {}) noexcept
+        : site_(site), budget_(budget), start_(thread_counts()) {}
+
+    ~Scope() {
+        const Counts d = delta();
+        if (SiteTotals* t = registry().totals(site_)) {
+            t->scopes.fetch_add(1, std::memory_order_relaxed);
+            t->allocations.fetch_add(d.allocations, std::memory_order_relaxed);
+            t->bytes.fetch_add(d.bytes, std::memory_order_relaxed);
+            t->copies.fetch_add(d.copies, std::memory_order_relaxed);
+            t->moves.fetch_add(d.moves, std::memory_order_relaxed);
+            if (!within(d)) t->over_budget.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!reported_ && !within(d)) {
+            // Destructors must not throw; say it loudly instead.
+            detail::Uncounted uncounted;
+            std::fprintf(stderr, "prof: scope '%s' over budget: %s\n", site_.name.c_str(), describe(d).c_str());
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // Counts so far in this scope (this thread only).
+    Counts delta() const noexcept { return thread_counts() - start_; }
+
+    // Throws BudgetExceeded if the scope is already over budget. The scope
+    // keeps counting afterwards; only the exception message is left out.
+    void check() {
+        const Counts d = delta();
+        if (within(d)) return;
+        reported_ = true;
+        detail::Uncounted uncounted;
+        throw BudgetExceeded("prof: scope '" + site_.name + "' over budget: " + describe(d));
+    }
+
+private:
+    bool within(const Counts& d) const noexcept {
+        return d.allocations <= budget_.allocations && d.bytes <= budget_.bytes && d.copies <= budget_.copies &&
+               d.moves <= budget_.moves;
+    }
+
+    std::string describe(const Counts& d) const {
+        auto field = [](const char* what, std::uint64_t got, std::uint64_t limit) {
+            if (got <= limit) return std::string();
+            return "; " + std::string(what) + " " + std::to_string(got) + " > " + std::to_string(limit);
+        };
+        const std::string s = field("allocations", d.allocations, budget_.allocations) +
+                              field("bytes", d.bytes, budget_.bytes) + field("copies", d.copies, budget_.copies) +
+                              field("moves", d.moves, budget_.moves);
+        return s.empty() ? s : s.substr(2);
+    }
+
+    AllocSite& site_;
+    Budget budget_;
+    Counts start_;
+    bool reported_ = false;  // check() already threw; don't warn again
+};
+
+// Runs f inside a scope and throws BudgetExceeded if it went over.
+template <class F>
+void expect_within(AllocSite& site, Budget budget, F&& f) {
+    Scope s(site, budget);
+    f();
+    s.check();
+}
+
+// =======================================================
+// Report
+// =======================================================
+inline std::string demangle(const std::type_info& t) {
+#if defined(__GNUG__)
+    int status = 0;
+    std::unique_ptr<char, void (*)(void*)> p(abi::__cxa_demangle(t.name(), nullptr, nullptr, &status), std::free);
+    if (status == 0 && p) return p.get();
+#endif
+    return t.name();
+}
+
+inline void Registry::dump(std::ostream& out) {
+    detail::Uncounted uncounted;
+    std::lock_guard<std::mutex> lock(mtx_);
+    struct Row {
+        const AllocSite* site;
+        const SiteTotals* t;
+    };
+    std::vector<Row> rows;
+    for (auto& s : sites_)
+        if (s->index < kMaxSites) rows.push_back({s.get(), &site_totals_[s->index]});
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.t->allocations.load(std::memory_order_relaxed) > b.t->allocations.load(std::memory_order_relaxed);
+    });
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-28s %8s %10s %12s %8s %8s %6s\n", "site", "scopes", "allocs", "bytes",
+                  "copies", "moves", "over");
+    out << line;
+    for (const Row& r : rows) {
+        std::snprintf(line, sizeof(line), "%-28s %8llu %10llu %12llu %8llu %8llu %6llu\n", r.site->name.c_str(),
+                      static_cast<unsigned long long>(r.t->scopes.load()),
+                      static_cast<unsigned long long>(r.t->allocations.load()),
+                      static_cast<unsigned long long>(r.t->bytes.load()),
+                      static_cast<unsigned long long>(r.t->copies.load()),
+                      static_cast<unsigned long long>(r.t->moves.load()),
+                      static_cast<unsigned long long>(r.t->over_budget.load()));
+        out << line;
+    }
+    if (sites_.size() > kMaxSites) out << "(" << sites_.size() - kMaxSites << " sites over kMaxSites not recorded)\n";
+
+    if (types_used_ == 0) return;
+    std::snprintf(line, sizeof(line), "\n%-28s %10s %10s\n", "type", "copies", "moves");
+    out << line;
+    for (std::size_t i = 0; i < types_used_; ++i) {
+        std::snprintf(line, sizeof(line), "%-28s %10llu %10llu\n", demangle(*type_totals_[i].type).c_str(),
+                      static_cast<unsigned long long>(type_totals_[i].copies.load()),
+                      static_cast<unsigned long long>(type_totals_[i].moves.load()));
+        out << line;
+    }
+}
+
+inline void dump(std::ostream& out) { registry().dump(out); }
+
+// =======================================================
+// Global operator new/delete replacements
+// =======================================================
+namespace detail {
+
+// 16 bytes in front of every block: requested size and the distance back
+// to what malloc / aligned_alloc returned.
+struct Header {
+    std::size_t size;
+    std::size_t offset;
+};
+static_assert(sizeof(Header) == 16);
+
+inline void* allocate(std::size_t n, std::size_t align) noexcept {
+    const std::size_t offset = std::max<std::size_t>(sizeof(Header), align);
+    if (n > std::numeric_limits<std::size_t>::max() - offset - align) return nullptr;  // header would not fit
+    void* base = align <= alignof(std::max_align_t) ? std::malloc(n + offset)
+                                                    : std::aligned_alloc(align, (n + offset + align - 1) / align * align);
+    if (!base) return nullptr;
+    auto* p = static_cast<char*>(base) + offset;
+    reinterpret_cast<Header*>(p)[-1] = {n, offset};
+    Counts& c = thread_counts();
+    ++c.allocations;
+    c.bytes += n;
+    return p;
+}
+
+inline void release(void* p) noexcept {
+    if (!p) return;
+    const Header h = reinterpret_cast<Header*>(p)[-1];
+    Counts& c = thread_counts();
+    ++c.frees;
+    c.bytes_freed += h.size;
+    std::free(static_cast<char*>(p) - h.offset);
+}
+
+inline void* allocate_or_throw(std::size_t n, std::size_t align) {
+    for (;;) {
+        if (void* p = allocate(n, align)) return p;
+        std::new_handler h = std::get_new_handler();
+        if (!h) throw std::bad_alloc();
+        h();
+    }
+}
+
+} // namespace detail
+} // namespace prof
+
+#if defined(XLAB_ALLOC_PROFILER_MAIN)
+void* operator new(std::size_t n) { return prof::detail::allocate_or_throw(n, alignof(std::max_align_t)); }
+void* operator new[](std::size_t n) { return prof::detail::allocate_or_throw(n, alignof(std::max_align_t)); }
+void* operator new(std::size_t n, std::align_val_t a) { return prof::detail::allocate_or_throw(n, std::size_t(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return prof::detail::allocate_or_throw(n, std::size_t(a)); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    return prof::detail::allocate(n, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    return prof::detail::allocate(n, alignof(std::max_align_t));
+}
+void operator delete(void* p) noexcept { prof::detail::release(p); }
+void operator delete[](void* p) noexcept { prof::detail::release(p); }
+void operator delete(void* p, std::size_t) noexcept { prof::detail::release(p); }
+void operator delete[](void* p, std::size_t) noexcept { prof::detail::release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { prof::detail::release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { prof::detail::release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { prof::detail::release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { prof::detail::release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { prof::detail::release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { prof::detail::release(p); }
+#endif
@@ -0,0 +1,177 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define XLAB_ALLOC_PROFILER_MAIN
+#include "allocProfiler.hpp"
+
+/* Usage
+./app              # copy/move cases, budget guard, 1M-allocation overhead run
+./app 10000000     # longer overhead run
+
+Build: g++ -std=c++20 -O2 allocProfilerBench.cpp -o app
+*/
+
+// Person from classDesign.cpp with a counter member. Names are longer
+// than the 15-char SSO buffer so every copy is also a heap allocation.
+class Person {
+public:
+    Person(std::string name, int age)
+        : name_(std::move(name)), age_(age) {}
+
+    const std::string& getName() const noexcept {
+        return name_;
+    }
+
+    int getAge() const noexcept {
+        return age_;
+    }
+
+private:
+    std::string name_;
+    int age_;
+    prof::Tracked<Person> track_;
+};
+
+// Same, but the user-declared destructor suppresses the implicit move
+// constructor: every "move" silently becomes a copy.
+class LegacyPerson {
+public:
+    LegacyPerson(std::string name, int age)
+        : name_(std::move(name)), age_(age) {}
+    LegacyPerson(const LegacyPerson&) = default;
+    ~LegacyPerson() {}
+
+private:
+    std::string name_;
+    int age_;
+    prof::Tracked<LegacyPerson> track_;
+};
+
+static std::string long_name(int i) {
+    return "Person-with-a-long-name-" + std::to_string(i);
+}
+
+// copyReferencePointer.cpp: by value vs by reference.
+static std::size_t name_length_by_value(Person p) { return p.getName().size(); }
+static std::size_t name_length_by_ref(const Person& p) { return p.getName().size(); }
+
+static void report(const char* what, const prof::Counts& d) {
+    std::printf("  %-40s %6llu allocs %6llu copies %6llu moves\n", what, static_cast<unsigned long long>(d.allocations),
+                static_cast<unsigned long long>(d.copies), static_cast<unsigned long long>(d.moves));
+}
+
+// Runs f under a scope named what, prints the scope's totals.
+template <class F>
+static void run_case(prof::AllocSite& site, const char* what, F f) {
+    prof::Scope s(site);
+    f();
+    report(what, s.delta());
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    constexpr int kPeople = 100;
+
+    std::vector<Person> people;
+    for (int i = 0; i < kPeople; ++i) people.emplace_back(long_name(i), 20 + i % 50);
+
+    // ---------------------------------------------------- copies vs moves
+    std::printf("[copy vs move] %d people\n", kPeople);
+
+    run_case(XLAB_ALLOC_SITE("push_back copy"), "push_back(p)", [&] {
+        std::vector<Person> out;
+        out.reserve(kPeople);
+        for (const Person& p : people) out.push_back(p);
+    });
+    run_case(XLAB_ALLOC_SITE("push_back move"), "push_back(std::move(p))", [&] {
+        std::vector<Person> src = people;   // copies counted by the outer scope only
+        prof::Scope inner(XLAB_ALLOC_SITE("push_back move (inner)"));
+        std::vector<Person> out;
+        out.reserve(kPeople);
+        for (Person& p : src) out.push_back(std::move(p));
+        report("  nested scope: the moves alone", inner.delta());
+    });
+    run_case(XLAB_ALLOC_SITE("emplace_back"), "emplace_back(name, age)", [&] {
+        std::vector<Person> out;
+        out.reserve(kPeople);
+        for (int i = 0; i < kPeople; ++i) out.emplace_back(long_name(i), i);
+    });
+    run_case(XLAB_ALLOC_SITE("growth, noexcept move"), "growth without reserve", [&] {
+        std::vector<Person> out;
+        for (int i = 0; i < kPeople; ++i) out.emplace_back(long_name(i), i);
+    });
+    run_case(XLAB_ALLOC_SITE("growth, no move ctor"), "growth, LegacyPerson (no move)", [&] {
+        std::vector<LegacyPerson> out;
+        for (int i = 0; i < kPeople; ++i) out.emplace_back(long_name(i), i);
+    });
+    run_case(XLAB_ALLOC_SITE("param by value"), "f(Person p)", [&] {
+        std::size_t total = 0;
+        for (const Person& p : people) total += name_length_by_value(p);
+        if (total == 0) std::puts("");
+    });
+    run_case(XLAB_ALLOC_SITE("param by const&"), "f(const Person& p)", [&] {
+        std::size_t total = 0;
+        for (const Person& p : people) total += name_length_by_ref(p);
+        if (total == 0) std::puts("");
+    });
+    run_case(XLAB_ALLOC_SITE("range-for by value"), "for (auto p : people)", [&] {
+        std::size_t total = 0;
+        for (auto p : people) total += p.getName().size();
+        if (total == 0) std::puts("");
+    });
+
+    // ---------------------------------------------------- budget guard
+    std::printf("\n[budget guard]\n");
+    try {
+        prof::expect_within(XLAB_ALLOC_SITE("hot path, by ref"), {.allocations = 0, .copies = 0}, [&] {
+            std::size_t total = 0;
+            for (const Person& p : people) total += name_length_by_ref(p);
+            if (total == 0) std::puts("");
+        });
+        std::printf("  by const&: within budget\n");
+
+        prof::expect_within(XLAB_ALLOC_SITE("hot path, by value"), {.allocations = 0, .copies = 0}, [&] {
+            std::size_t total = 0;
+            for (const Person& p : people) total += name_length_by_value(p);
+            if (total == 0) std::puts("");
+        });
+        std::printf("  by value: within budget (unexpected)\n");
+    } catch (const prof::BudgetExceeded& e) {
+        std::printf("  %s\n", e.what());
+    }
+
+    // ---------------------------------------------------- report
+    std::printf("\n[report]\n");
+    prof::dump(std::cout);
+
+    // ---------------------------------------------------- overhead
+    // Per-thread counters only, so the cost over plain malloc/free is the
+    // header write plus a few adds.
+    std::printf("\n[overhead] %zu new/delete pairs of 32 bytes\n", n);
+    using Clock = std::chrono::steady_clock;
+    {
+        auto t0 = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            void* p = std::malloc(32);
+            asm volatile("" : : "g"(p) : "memory");
+            std::free(p);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / double(n);
+        std::printf("  %-40s %8.1f ns/pair\n", "malloc/free", ns);
+    }
+    {
+        auto t0 = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            auto* p = new char[32];
+            asm volatile("" : : "g"(p) : "memory");
+            delete[] p;
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / double(n);
+        std::printf("  %-40s %8.1f ns/pair\n", "profiled new/delete", ns);
+    }
+    return 0;
+}
@@ -4,48 +4,676 @@
 #include <vector>
 #include <atomic>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <numbers>
+#include <numeric>
+#include <random>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <time.h>
 
 /* Usage
-./app 25 20 4   # ~25% load on 4 threads for 20s
-./app 80 10 1   # ~80% on 1 thread
+./app 25 20 4                         # ~25% load on 4 threads for 20s
+./app 80 10 1                         # ~80% on 1 thread
+./app 50 30 4 --cpus=0,2,4,6          # pin worker i to cpus[i]
+./app 50 30 3 --cpus=0,1,2 --targets=20,50,90   # per-core targets
+./app 50 10 2 --open-loop             # old fixed duty cycle, for comparison
+./app 100 10 4 --kernel=fma           # AVX2/FMA floating point, reports GFLOP/s
+./app 100 10 4 --kernel=stream        # memory bandwidth (64MB triad per worker), GB/s
+./app 80 10 2 --kernel=cache --ws-kb=4096   # random loads in a 4MB working set
+./app 60 10 2 --kernel=branch         # unpredictable branches
+./app 0 60 4 --shape=ramp:10:90 --csv=load.csv      # 10% -> 90% over 60s, log to CSV
+./app 0 60 4 --shape=step:20,50,80:10               # hold each level 10s (repeats)
+./app 0 60 4 --shape=sine:50:30:20                  # 50% +- 30%, 20s period
+./app 0 60 4 --shape=burst:10:95:15:3               # 10%, 95% for 3s every 15s
+./app 0 300 8 --shape=csv:trace.csv                 # percent per line = per second, or t,percent
 */
 
-static void load_worker(std::atomic<bool>& stop, int percent) {
-    percent = std::clamp(percent, 0, 100);
+struct Config {
+    int percent = 50;
+    int seconds = 10;
+    unsigned threads = 1;
+    std::vector<int> cpus;        // empty: no pinning
+    std::vector<int> targets;     // empty: every worker uses `percent`
+    int period_ms = 100;          // control period
+    int log_ms = 1000;            // report interval
+    bool open_loop = false;
+    std::string kernel = "int";
+    std::size_t ws_kb = 4096;       // cache kernel working set (per worker)
+    std::size_t stream_mb = 64;     // stream kernel buffer size (per array, per worker)
+    std::string shape;              // empty: constant `percent`
+    std::string csv_path;           // empty: no CSV log
+};
+
+// CPU time consumed by the calling thread (excludes time preempted/sleeping).
+static std::int64_t thread_cpu_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// user + system CPU time of the whole process.
+static std::int64_t process_cpu_ns() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    auto tv_ns = [](const timeval& tv) { return static_cast<std::int64_t>(tv.tv_sec) * 1000000000LL + tv.tv_usec * 1000LL; };
+    return tv_ns(ru.ru_utime) + tv_ns(ru.ru_stime);
+}
+
+static std::int64_t wall_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Shared between a worker and the reporting thread. cpu_ns/wall_ns are
+// published together at the end of every control period, so the reporter
+// computes achieved load over whole periods.
+struct Worker {
+    std::atomic<double> target{0.5};          // requested utilization, 0..1
+    std::atomic<std::int64_t> cpu_ns{0};      // cumulative thread CPU time
+    std::atomic<std::int64_t> wall_ns{0};     // when cpu_ns was sampled
+    std::atomic<std::uint64_t> ops{0};        // kernel work done (unit per kernel)
+    std::uint64_t ops_local = 0;              // worker thread only
+    int cpu = -1;                             // pinned core, -1: none
+
+    void publish() {
+        ops.store(ops_local, std::memory_order_relaxed);
+        cpu_ns.store(thread_cpu_ns(), std::memory_order_relaxed);
+        wall_ns.store(::wall_ns(), std::memory_order_release);
+    }
+};
+
+static bool pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;  // 0 = calling thread
+}
 
-    const auto period = std::chrono::milliseconds(100); // control granularity
-    auto busy = period * percent / 100;
-    auto idle = period - busy;
+// =======================================================
+// Stress kernels
+//   Each step() does a short slice of work (~5-50 us) and returns how many
+//   units it did; the worker checks its CPU-time budget between steps.
+// =======================================================
+struct Kernel {
+    virtual ~Kernel() = default;
+    virtual std::uint64_t step() = 0;
+};
 
+// Integer: the original LCG, one dependent multiply-add chain (one ALU port).
+struct IntKernel : Kernel {
     volatile std::uint64_t x = 0;
+    std::uint64_t step() override {
+        std::uint64_t v = x;
+        for (int i = 0; i < 4096; ++i) v = v * 1664525u + 1013904223u;
+        x = v;
+        return 4096;
+    }
+};
+
+// SIMD FP: 8 independent 256-bit FMA chains keep both FMA ports busy
+// (latency 4 x 2 ports). Falls back to scalar FMA without AVX2/FMA.
+struct FmaKernel : Kernel {
+    double sink = 0.0;
+    bool simd = false;
+
+    FmaKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+        simd = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2,fma"))) std::uint64_t step_avx2() {
+        constexpr int kIters = 8192;
+        const __m256 a = _mm256_set1_ps(0.999999f), b = _mm256_set1_ps(1e-6f);
+        // Named accumulators: an array of __m256 is kept in memory by GCC,
+        // which serializes the chains through store forwarding.
+        __m256 c0 = _mm256_set1_ps(0.f), c1 = _mm256_set1_ps(1.f), c2 = _mm256_set1_ps(2.f), c3 = _mm256_set1_ps(3.f);
+        __m256 c4 = _mm256_set1_ps(4.f), c5 = _mm256_set1_ps(5.f), c6 = _mm256_set1_ps(6.f), c7 = _mm256_set1_ps(7.f);
+        for (int i = 0; i < kIters; ++i) {
+            c0 = _mm256_fmadd_ps(c0, a, b); c1 = _mm256_fmadd_ps(c1, a, b);
+            c2 = _mm256_fmadd_ps(c2, a, b); c3 = _mm256_fmadd_ps(c3, a, b);
+            c4 = _mm256_fmadd_ps(c4, a, b); c5 = _mm256_fmadd_ps(c5, a, b);
+            c6 = _mm256_fmadd_ps(c6, a, b); c7 = _mm256_fmadd_ps(c7, a, b);
+        }
+        __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(c0, c1), _mm256_add_ps(c2, c3)),
+                                   _mm256_add_ps(_mm256_add_ps(c4, c5), _mm256_add_ps(c6, c7)));
+        float out[8];
+        _mm256_storeu_ps(out, sum);
+        sink += out[0];
+        return std::uint64_t{kIters} * 8 * 8 * 2;  // chains * lanes * (mul + add)
+    }
+#endif
+
+    std::uint64_t step() override {
+#if defined(__x86_64__) || defined(__i386__)
+        if (simd) return step_avx2();
+#endif
+        constexpr int kIters = 2048;
+        double acc[8];
+        for (int k = 0; k < 8; ++k) acc[k] = k;
+        for (int i = 0; i < kIters; ++i) {
+            for (int k = 0; k < 8; ++k) acc[k] = std::fma(acc[k], 0.999999, 1e-6);
+        }
+        for (double v : acc) sink += v;
+        return std::uint64_t{kIters} * 8 * 2;
+    }
+};
+
+// Memory bandwidth: STREAM triad a = b + s * c over buffers far larger than
+// the LLC, 64K elements per step. Counts bytes moved (2 reads + 1 write).
+struct StreamKernel : Kernel {
+    std::vector<double> a, b, c;
+    std::size_t pos = 0;
+
+    explicit StreamKernel(std::size_t mb)
+        : a(std::max<std::size_t>(mb << 20, 1 << 20) / sizeof(double), 0.0), b(a.size(), 1.0), c(a.size(), 2.0) {}
+
+    std::uint64_t step() override {
+        constexpr std::size_t kChunk = 64 * 1024;
+        const std::size_t n = std::min(kChunk, a.size() - pos);
+        double* __restrict pa = a.data() + pos;
+        const double* __restrict pb = b.data() + pos;
+        const double* __restrict pc = c.data() + pos;
+        for (std::size_t i = 0; i < n; ++i) pa[i] = pb[i] + 3.0 * pc[i];
+        pos = (pos + n == a.size()) ? 0 : pos + n;
+        return n * 3 * sizeof(double);
+    }
+};
+
+// Cache thrash: dependent random loads through one random cycle (Sattolo)
+// covering a working set sized to L2 or L3. Counts loads.
+struct CacheKernel : Kernel {
+    std::vector<std::uint32_t> next;
+    std::uint32_t cur = 0;
+
+    explicit CacheKernel(std::size_t kb) : next(std::max<std::size_t>(kb * 1024 / sizeof(std::uint32_t), 16)) {
+        std::iota(next.begin(), next.end(), 0u);
+        std::mt19937 rng(12345);
+        for (std::size_t i = next.size() - 1; i > 0; --i) {
+            std::uniform_int_distribution<std::size_t> pick(0, i - 1);
+            std::swap(next[i], next[pick(rng)]);
+        }
+    }
+
+    std::uint64_t step() override {
+        std::uint32_t p = cur;
+        for (int i = 0; i < 4096; ++i) p = next[p];
+        cur = p;
+        return 4096;
+    }
+};
+
+// Branch mispredicts: branch on random bits, ~50% mispredicted. The empty
+// asm in one arm keeps the compiler from turning the branch into a cmov.
+struct BranchKernel : Kernel {
+    std::vector<std::uint8_t> bits;
+    std::size_t pos = 0;
+    std::uint64_t acc = 0;
+
+    BranchKernel() : bits(1 << 16) {
+        std::mt19937 rng(6789);
+        for (auto& v : bits) v = static_cast<std::uint8_t>(rng() & 1);
+    }
+
+    std::uint64_t step() override {
+        std::uint64_t x = acc;
+        for (int i = 0; i < 4096; ++i) {
+            if (bits[(pos + i) & (bits.size() - 1)]) {
+                x = x * 3 + 1;
+                asm volatile("" : "+r"(x));
+            } else {
+                x ^= x >> 7;
+            }
+        }
+        pos += 4096;
+        acc = x;
+        return 4096;
+    }
+};
+
+struct KernelInfo {
+    const char* name;
+    const char* unit;     // reported throughput unit
+    double per_unit;      // ops per reported unit
+    const char* help;
+};
+
+static const KernelInfo kKernels[] = {
+    {"int", "Mops/s", 1e6, "integer LCG chain (original)"},
+    {"fma", "GFLOP/s", 1e9, "AVX2/FMA floating point"},
+    {"stream", "GB/s", 1e9, "streaming triad, --stream-mb per array"},
+    {"cache", "Mloads/s", 1e6, "random dependent loads, --ws-kb working set"},
+    {"branch", "Mbranches/s", 1e6, "unpredictable branches"},
+};
+
+static const KernelInfo& find_kernel(const std::string& name) {
+    for (const auto& k : kKernels) {
+        if (name == k.name) return k;
+    }
+    throw std::runtime_error("unknown kernel " + name);
+}
+
+static std::unique_ptr<Kernel> make_kernel(const Config& cfg) {
+    if (cfg.kernel == "fma") return std::make_unique<FmaKernel>();
+    if (cfg.kernel == "stream") return std::make_unique<StreamKernel>(cfg.stream_mb);
+    if (cfg.kernel == "cache") return std::make_unique<CacheKernel>(cfg.ws_kb);
+    if (cfg.kernel == "branch") return std::make_unique<BranchKernel>();
+    return std::make_unique<IntKernel>();
+}
+
+// Busy work for `budget_ns` of this thread's CPU time, or until the wall
+// deadline (when the core is oversubscribed CPU time advances slower than
+// wall time). The clock is read after every kernel step.
+static void burn(Worker& w, Kernel& k, std::int64_t cpu_start, std::int64_t budget_ns,
+                 std::chrono::steady_clock::time_point deadline) {
+    for (;;) {
+        w.ops_local += k.step();
+        if (thread_cpu_ns() - cpu_start >= budget_ns) return;
+        if (std::chrono::steady_clock::now() >= deadline) return;
+    }
+}
+
+// Open loop (original behaviour): busy for percent% of every period by wall
+// clock, sleep the rest. Drifts with frequency scaling, SMT and preemption.
+static void open_loop_worker(std::atomic<bool>& stop, Worker& w, Kernel& k, std::chrono::milliseconds period) {
     while (!stop.load(std::memory_order_relaxed)) {
+        const double duty = std::clamp(w.target.load(std::memory_order_relaxed), 0.0, 1.0);
+        auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(period * duty);
         auto t0 = std::chrono::steady_clock::now();
         while (std::chrono::steady_clock::now() - t0 < busy) {
-            x = x * 1664525u + 1013904223u;
+            w.ops_local += k.step();
         }
-        if (idle.count() > 0) std::this_thread::sleep_for(idle);
+        std::this_thread::sleep_until(t0 + period);
+        w.publish();
     }
 }
 
+// Closed loop: every period, burn duty * period of *thread CPU time*, sleep
+// to the period boundary, then measure achieved = cpu / wall and correct
+// the duty with a PI controller. CPU time (not wall time) means preemption
+// does not count as work, and the integral term absorbs sleep overshoot and
+// timer slack.
+static void load_worker(std::atomic<bool>& stop, Worker& w, Kernel& k, std::chrono::milliseconds period) {
+    constexpr double kP = 0.3;
+    constexpr double kI = 0.2;
+
+    const std::int64_t period_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(period).count();
+    double integral = 0.0;
+    double error = 0.0;
+    auto next = std::chrono::steady_clock::now();
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        // Target is re-read every period, so it may change while running.
+        const double target = std::clamp(w.target.load(std::memory_order_relaxed), 0.0, 1.0);
+        const double duty = std::clamp(target + kP * error + integral, 0.0, 1.0);
+
+        auto start = next;
+        next += period;
+        const std::int64_t cpu0 = thread_cpu_ns();
+        if (duty > 0.0) burn(w, k, cpu0, static_cast<std::int64_t>(duty * static_cast<double>(period_ns)), next);
+        std::this_thread::sleep_until(next);
+
+        const std::int64_t cpu1 = thread_cpu_ns();
+        auto now = std::chrono::steady_clock::now();
+        // Missed the boundary (long preemption): restart the schedule from now.
+        if (now - next > period) next = now;
+
+        const double wall = std::chrono::duration<double, std::nano>(now - start).count();
+        const double achieved = wall > 0 ? static_cast<double>(cpu1 - cpu0) / wall : 0.0;
+        error = target - achieved;
+        // Anti-windup: stop integrating while the duty is saturated, or a
+        // step from 100% down to 20% would stay pinned at 100% for seconds.
+        const bool saturated = (duty >= 1.0 && error > 0) || (duty <= 0.0 && error < 0);
+        if (!saturated) integral = std::clamp(integral + kI * error, -1.0, 1.0);
+
+        w.publish();
+    }
+}
+
+static std::vector<int> parse_list(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(std::stoi(item));
+    }
+    return out;
+}
+
+// =======================================================
+// Load shapes: requested percent as a function of time since start
+// =======================================================
+using LoadShape = std::function<double(double)>;
+
+static std::vector<double> parse_doubles(const std::string& s, char sep) {
+    std::vector<double> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, sep)) {
+        if (!item.empty()) out.push_back(std::stod(item));
+    }
+    return out;
+}
+
+// Trace file: one percent per line (line i = second i), or "t,percent"
+// lines with t in seconds, strictly increasing (any spacing, gaps allowed).
+// Blank lines and '#' comments are skipped, and so is the first line if it
+// is a non-numeric header; anything else that does not parse is an error.
+// Each value holds until the next sample's time, the last one until the end.
+static LoadShape trace_shape(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open trace " + path);
+
+    auto number = [&](const std::string& field, std::size_t line_no) {
+        const auto first = field.find_first_not_of(" \t\r");
+        const auto last = field.find_last_not_of(" \t\r");
+        std::size_t used = 0;
+        double v = 0;
+        try {
+            if (first != std::string::npos) v = std::stod(field.substr(first, last - first + 1), &used);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+        if (first == std::string::npos || used != last - first + 1 || !std::isfinite(v))
+            throw std::runtime_error("trace " + path + ":" + std::to_string(line_no) + ": '" + field + "' is not a number");
+        return v;
+    };
+
+    std::vector<double> times, percents;
+    std::size_t columns = 0;
+    bool seen_data_or_header = false;
+    std::string line;
+    for (std::size_t line_no = 1; std::getline(in, line); ++line_no) {
+        const auto start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+        line = line.substr(start);
+
+        const bool header = !seen_data_or_header && !(std::isdigit(static_cast<unsigned char>(line[0])) ||
+                                                      line[0] == '.' || line[0] == '-' || line[0] == '+');
+        seen_data_or_header = true;
+        if (header) continue;
+
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        for (std::string f; std::getline(ss, f, ',');) fields.push_back(f);
+        auto where = [&] { return "trace " + path + ":" + std::to_string(line_no) + ": "; };
+        if (fields.empty() || fields.size() > 2) throw std::runtime_error(where() + "expected 'percent' or 't,percent'");
+        if (columns == 0) columns = fields.size();
+        if (fields.size() != columns) throw std::runtime_error(where() + "column count differs from the first sample");
+
+        const double t = columns == 2 ? number(fields[0], line_no) : static_cast<double>(percents.size());
+        const double pct = number(fields.back(), line_no);
+        if (t < 0 || (!times.empty() && t <= times.back()))
+            throw std::runtime_error(where() + "time must be >= 0 and strictly increasing");
+        if (pct < 0 || pct > 100) throw std::runtime_error(where() + "percent must be in [0, 100]");
+        times.push_back(t);
+        percents.push_back(pct);
+    }
+    if (percents.empty()) throw std::runtime_error("trace " + path + " has no samples");
+
+    // Before the first sample the first value applies.
+    return [times, percents](double t) {
+        const auto it = std::upper_bound(times.begin(), times.end(), t);
+        return percents[it == times.begin() ? 0 : static_cast<std::size_t>(it - times.begin()) - 1];
+    };
+}
+
+// ramp:FROM:TO              linear over the whole run
+// step:P1,P2,...:SECS       each level for SECS, then repeat
+// sine:MEAN:AMP:PERIOD_S
+// burst:BASE:PEAK:EVERY_S:LEN_S
+// csv:FILE
+static LoadShape parse_shape(const std::string& spec, double run_seconds) {
+    const auto colon = spec.find(':');
+    const std::string kind = spec.substr(0, colon);
+    const std::string rest = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+    if (kind == "csv") return trace_shape(rest);
+    if (kind == "step") {
+        const auto last = rest.rfind(':');
+        if (last == std::string::npos) throw std::runtime_error("step needs LEVELS:SECS");
+        auto levels = parse_doubles(rest.substr(0, last), ',');
+        const double hold = std::stod(rest.substr(last + 1));
+        if (levels.empty() || hold <= 0) throw std::runtime_error("step needs levels and SECS > 0");
+        return [levels, hold](double t) {
+            return levels[static_cast<std::size_t>(t / hold) % levels.size()];
+        };
+    }
+
+    auto args = parse_doubles(rest, ':');
+    auto need = [&](std::size_t n) {
+        if (args.size() != n) throw std::runtime_error(kind + " needs " + std::to_string(n) + " values");
+    };
+    if (kind == "ramp") {
+        need(2);
+        const double from = args[0], to = args[1];
+        return [=](double t) { return from + (to - from) * std::clamp(t / run_seconds, 0.0, 1.0); };
+    }
+    if (kind == "sine") {
+        need(3);
+        const double mean = args[0], amp = args[1], period = args[2];
+        if (period <= 0) throw std::runtime_error("sine period must be > 0");
+        return [=](double t) { return mean + amp * std::sin(2.0 * std::numbers::pi * t / period); };
+    }
+    if (kind == "burst") {
+        need(4);
+        const double base = args[0], peak = args[1], every = args[2], len = args[3];
+        if (every <= 0) throw std::runtime_error("burst interval must be > 0");
+        return [=](double t) { return std::fmod(t, every) < len ? peak : base; };
+    }
+    throw std::runtime_error("unknown shape " + kind + " (ramp | step | sine | burst | csv)");
+}
+
+static void print_usage(const char* prog) {
+    std::cout
+        << "Usage:\n"
+        << "  " << prog << " [percent=50] [seconds=10] [threads=1] [options]\n"
+        << "Options:\n"
+        << "  --cpus=0,2,4     pin worker i to cpus[i % n] (sched_setaffinity)\n"
+        << "  --targets=20,80  per-worker target percent (worker i uses targets[i % n])\n"
+        << "  --period-ms=100  control period\n"
+        << "  --log-ms=1000    report interval (achieved vs requested)\n"
+        << "  --open-loop      fixed wall-clock duty cycle, no feedback\n"
+        << "  --kernel=NAME    busy-loop kernel (default int):\n";
+    for (const auto& k : kKernels) std::cout << "                     " << k.name << ": " << k.help << " [" << k.unit << "]\n";
+    std::cout
+        << "  --ws-kb=4096     cache kernel working set per worker\n"
+        << "  --stream-mb=64   stream kernel array size per worker\n"
+        << "  --shape=SPEC     requested load over time, replaces percent (all workers):\n"
+        << "                     ramp:FROM:TO | step:P1,P2,..:SECS | sine:MEAN:AMP:PERIOD_S\n"
+        << "                     burst:BASE:PEAK:EVERY_S:LEN_S | csv:FILE (percent per second, or t,percent)\n"
+        << "  --csv=FILE       write requested vs achieved per report interval\n";
+}
+
 int main(int argc, char** argv) {
-    // Usage: ./cpu_load [percent=50] [seconds=10] [threads=1]
-    int percent = (argc > 1) ? std::stoi(argv[1]) : 50;
-    int seconds = (argc > 2) ? std::stoi(argv[2]) : 10;
-    unsigned threads = (argc > 3) ? static_cast<unsigned>(std::stoul(argv[3])) : 1;
+    Config cfg;
+    LoadShape shape;
+    std::ofstream csv;
+
+    try {
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            auto value = [&](const std::string& key) { return a.substr(key.size()); };
+            if (a.rfind("--cpus=", 0) == 0) cfg.cpus = parse_list(value("--cpus="));
+            else if (a.rfind("--targets=", 0) == 0) cfg.targets = parse_list(value("--targets="));
+            else if (a.rfind("--period-ms=", 0) == 0) cfg.period_ms = std::stoi(value("--period-ms="));
+            else if (a.rfind("--log-ms=", 0) == 0) cfg.log_ms = std::stoi(value("--log-ms="));
+            else if (a == "--open-loop") cfg.open_loop = true;
+            else if (a.rfind("--kernel=", 0) == 0) cfg.kernel = value("--kernel=");
+            else if (a.rfind("--ws-kb=", 0) == 0) cfg.ws_kb = std::stoul(value("--ws-kb="));
+            else if (a.rfind("--stream-mb=", 0) == 0) cfg.stream_mb = std::stoul(value("--stream-mb="));
+            else if (a.rfind("--shape=", 0) == 0) cfg.shape = value("--shape=");
+            else if (a.rfind("--csv=", 0) == 0) cfg.csv_path = value("--csv=");
+            else if (a.rfind("--", 0) == 0) throw std::runtime_error("unknown option " + a);
+            else positional.push_back(a);
+        }
+        if (positional.size() > 3) throw std::runtime_error("too many arguments");
+        if (positional.size() > 0) cfg.percent = std::stoi(positional[0]);
+        if (positional.size() > 1) cfg.seconds = std::stoi(positional[1]);
+        if (positional.size() > 2) cfg.threads = static_cast<unsigned>(std::stoul(positional[2]));
+
+        if (cfg.threads == 0) throw std::runtime_error("threads must be > 0");
+        if (cfg.period_ms <= 0 || cfg.log_ms <= 0) throw std::runtime_error("periods must be > 0");
+        find_kernel(cfg.kernel);
+        if (!cfg.shape.empty() && !cfg.targets.empty()) throw std::runtime_error("--shape and --targets are exclusive");
+        if (!cfg.shape.empty()) shape = parse_shape(cfg.shape, cfg.seconds);
+        if (!cfg.csv_path.empty()) {
+            csv.open(cfg.csv_path);
+            if (!csv) throw std::runtime_error("cannot write " + cfg.csv_path);
+        }
+
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        sched_getaffinity(0, sizeof(allowed), &allowed);
+        for (int c : cfg.cpus) {
+            if (c < 0 || c >= CPU_SETSIZE || !CPU_ISSET(c, &allowed))
+                throw std::runtime_error("cpu " + std::to_string(c) + " is not in this process's affinity mask");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
 
     std::atomic<bool> stop{false};
+    std::vector<std::unique_ptr<Worker>> workers;
     std::vector<std::thread> pool;
-    pool.reserve(threads);
+    pool.reserve(cfg.threads);
+    const auto period = std::chrono::milliseconds(cfg.period_ms);
+    const KernelInfo& kinfo = find_kernel(cfg.kernel);
 
-    for (unsigned i = 0; i < threads; ++i)
-        pool.emplace_back(load_worker, std::ref(stop), percent);
+    for (unsigned i = 0; i < cfg.threads; ++i) {
+        auto w = std::make_unique<Worker>();
+        double pct = cfg.targets.empty() ? cfg.percent : cfg.targets[i % cfg.targets.size()];
+        if (shape) pct = shape(0.0);
+        w->target.store(std::clamp(pct, 0.0, 100.0) / 100.0);
+        if (!cfg.cpus.empty()) w->cpu = cfg.cpus[i % cfg.cpus.size()];
+        workers.push_back(std::move(w));
+    }
+
+    for (unsigned i = 0; i < cfg.threads; ++i) {
+        Worker& w = *workers[i];
+        pool.emplace_back([&stop, &w, &cfg, period] {
+            if (w.cpu >= 0 && !pin_to_cpu(w.cpu)) std::perror("sched_setaffinity");
+            // Allocated after pinning so buffers are first-touched on the worker's node.
+            auto kernel = make_kernel(cfg);
+            w.publish();
+            if (cfg.open_loop) open_loop_worker(stop, w, *kernel, period);
+            else load_worker(stop, w, *kernel, period);
+        });
+    }
+
+    // Every control period: apply the shape. Every log interval: report
+    // achieved (per-thread CPU time) vs requested (mean over the interval),
+    // plus the whole process from getrusage.
+    const auto t_start = std::chrono::steady_clock::now();
+    const auto t_end = t_start + std::chrono::seconds(cfg.seconds);
+    const auto log_every = std::chrono::milliseconds(cfg.log_ms);
+    std::vector<std::int64_t> last_cpu(cfg.threads, 0), last_wall(cfg.threads, wall_ns());
+    std::vector<double> req_accum(cfg.threads, 0.0);
+    int req_samples = 0;
+    std::int64_t last_proc = process_cpu_ns();
+    std::uint64_t last_ops = 0;
+    auto last = t_start;
+    auto next_tick = t_start;
+
+    auto total_ops = [&] {
+        std::uint64_t sum = 0;
+        for (const auto& w : workers) sum += w->ops.load(std::memory_order_relaxed);
+        return sum;
+    };
+
+    if (csv) {
+        csv << "t_s,requested_pct,achieved_pct,process_pct," << kinfo.name << "_" << kinfo.unit;
+        for (unsigned i = 0; i < cfg.threads; ++i) csv << ",w" << i << "_requested,w" << i << "_achieved";
+        csv << "\n";
+    }
+
+    while (std::chrono::steady_clock::now() < t_end) {
+        next_tick += period;
+        std::this_thread::sleep_until(std::min(t_end, next_tick));
+        auto now = std::chrono::steady_clock::now();
+        const double t = std::chrono::duration<double>(now - t_start).count();
+
+        if (shape) {
+            const double target = std::clamp(shape(t), 0.0, 100.0) / 100.0;
+            for (auto& w : workers) w->target.store(target, std::memory_order_relaxed);
+        }
+        for (unsigned i = 0; i < cfg.threads; ++i) req_accum[i] += workers[i]->target.load(std::memory_order_relaxed);
+        ++req_samples;
+
+        if (now - last < log_every && now < t_end) continue;
+
+        const double wall = std::chrono::duration<double, std::nano>(now - last).count();
+        std::printf("t=%6.1fs", t);
+        std::vector<double> req(cfg.threads), ach(cfg.threads);
+        double req_sum = 0, ach_sum = 0;
+        for (unsigned i = 0; i < cfg.threads; ++i) {
+            const std::int64_t w_ns = workers[i]->wall_ns.load(std::memory_order_acquire);
+            const std::int64_t cpu = workers[i]->cpu_ns.load(std::memory_order_relaxed);
+            req[i] = 100.0 * req_accum[i] / req_samples;
+            ach[i] = w_ns > last_wall[i] ? 100.0 * static_cast<double>(cpu - last_cpu[i]) / static_cast<double>(w_ns - last_wall[i]) : 0.0;
+            last_cpu[i] = cpu;
+            last_wall[i] = w_ns;
+            req_accum[i] = 0.0;
+            req_sum += req[i];
+            ach_sum += ach[i];
+            if (workers[i]->cpu >= 0) std::printf("  cpu%d %3.0f/%5.1f%%", workers[i]->cpu, req[i], ach[i]);
+            else std::printf("  w%u %3.0f/%5.1f%%", i, req[i], ach[i]);
+        }
+        req_samples = 0;
+        const std::int64_t proc = process_cpu_ns();
+        const std::uint64_t ops = total_ops();
+        const double proc_pct = 100.0 * static_cast<double>(proc - last_proc) / wall;
+        const double rate = static_cast<double>(ops - last_ops) / (wall / 1e9) / kinfo.per_unit;
+        std::printf("  | mean %5.1f/%5.1f%%  process %5.1f%%  %s %.2f %s\n", req_sum / cfg.threads, ach_sum / cfg.threads,
+                    proc_pct, kinfo.name, rate, kinfo.unit);
+        std::fflush(stdout);
+
+        if (csv) {
+            csv << t << "," << req_sum / cfg.threads << "," << ach_sum / cfg.threads << "," << proc_pct << "," << rate;
+            for (unsigned i = 0; i < cfg.threads; ++i) csv << "," << req[i] << "," << ach[i];
+            csv << "\n";
+            csv.flush();
+        }
+        last_proc = proc;
+        last_ops = ops;
+        last = now;
+    }
 
-    std::this_thread::sleep_for(std::chrono::seconds(seconds));
     stop.store(true);
 
     for (auto& t : pool) t.join();
 
-    std::cout << "Done: ~" << percent << "% for " << seconds
-              << "s, threads=" << threads << "\n";
+    // Throughput per wall second, and per busy CPU-second (the kernel's
+    // rate independent of the duty cycle).
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+    double busy_s = 0;
+    for (const auto& w : workers) busy_s += static_cast<double>(w->cpu_ns.load()) / 1e9;
+    const double ops = static_cast<double>(total_ops()) / kinfo.per_unit;
+    std::cout << "Done: ~" << (cfg.shape.empty() ? std::to_string(cfg.percent) + "%" : cfg.shape) << " for " << cfg.seconds
+              << "s, threads=" << cfg.threads << (cfg.open_loop ? " (open loop)" : " (closed loop)") << "\n"
+              << "Kernel " << kinfo.name << ": " << ops / elapsed << " " << kinfo.unit << " total, "
+              << (busy_s > 0 ? ops / busy_s : 0.0) << " " << kinfo.unit << " per busy core\n";
     return 0;
 }
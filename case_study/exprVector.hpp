@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// =======================================================
+// Expression-template vectors
+//   add<T>(a, b) in templateTypename.cpp returns a + b by value. For
+//   containers, `a + b * c - d` written that way builds a full temporary
+//   per operator and walks memory once per operator. Here the operators
+//   only build a small expression object. The loop runs once, when the
+//   expression is assigned to a Vec:
+//
+//     expr::Vec<double> r = a + b * c - d;   // one pass, no temporaries
+//
+//   Mixed element types promote at compile time through std::common_type,
+//   so Vec<int> + Vec<double> is a double expression, and so is
+//   expr::add(3, 2.5), the call templateTypename.cpp says is rejected.
+//
+//   The assignment loop is compiled once per CPU level (AVX-512, AVX2,
+//   baseline) and the loader picks the clone from CPUID, so the fused
+//   loop runs as SIMD without -march flags.
+//
+//   Expressions hold pointers into their Vecs: assign them to a Vec,
+//   don't keep them in `auto` variables past the operands' lifetime.
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall exprVectorBench.cpp
+// =======================================================
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define XLAB_EXPR_SIMD __attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-vectorize")))
+#else
+#define XLAB_EXPR_SIMD
+#endif
+
+namespace expr {
+
+// Anything with value_type, size() and operator[](i) that opts in.
+template <class E>
+concept Expression = requires { typename std::remove_cvref_t<E>::is_expression; };
+
+template <class T>
+concept Arithmetic = std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
+// =======================================================
+// Nodes (all trivially copyable; held by value inside each other)
+// =======================================================
+template <class T>
+struct Leaf {
+    using is_expression = void;
+    using value_type = T;
+    const T* p;
+    std::size_t n;
+    std::size_t size() const { return n; }
+    T operator[](std::size_t i) const { return p[i]; }
+};
+
+template <class T>
+struct Broadcast {
+    using is_expression = void;
+    using value_type = T;
+    T v;
+    T operator[](std::size_t) const { return v; }
+};
+
+template <class E>
+inline constexpr bool is_broadcast = false;
+template <class T>
+inline constexpr bool is_broadcast<Broadcast<T>> = true;
+
+template <class Op, class L, class R>
+struct Binary {
+    using is_expression = void;
+    using value_type = std::common_type_t<typename L::value_type, typename R::value_type>;
+    L l;
+    R r;
+
+    std::size_t size() const {
+        if constexpr (is_broadcast<L>) return r.size();
+        else return l.size();
+    }
+    value_type operator[](std::size_t i) const {
+        return Op{}(static_cast<value_type>(l[i]), static_cast<value_type>(r[i]));
+    }
+};
+
+template <class Op, class E>
+struct Unary {
+    using is_expression = void;
+    using value_type = typename E::value_type;
+    E e;
+    std::size_t size() const { return e.size(); }
+    value_type operator[](std::size_t i) const { return Op{}(e[i]); }
+};
+
+// =======================================================
+// Vec: the owning container
+// =======================================================
+template <class T>
+class Vec {
+public:
+    using is_expression = void;
+    using value_type = T;
+
+    Vec() = default;
+    explicit Vec(std::size_t n, T value = T{}) : data_(n, value) {}
+    Vec(std::initializer_list<T> init) : data_(init) {}
+
+    // Evaluates the whole expression in one pass.
+    template <Expression E>
+        requires(!std::is_same_v<std::remove_cvref_t<E>, Vec>)
+    Vec(const E& e) : data_(e.size()) {
+        assign(data_.data(), as_node(e), data_.size());
+    }
+
+    template <Expression E>
+        requires(!std::is_same_v<std::remove_cvref_t<E>, Vec>)
+    Vec& operator=(const E& e) {
+        const auto node = as_node(e);
+        if (node.size() != data_.size()) {
+            // Evaluate first: the expression may read this Vec.
+            Vec tmp(e);
+            data_.swap(tmp.data_);
+        } else {
+            assign(data_.data(), node, data_.size());
+        }
+        return *this;
+    }
+
+    std::size_t size() const noexcept { return data_.size(); }
+    T* data() noexcept { return data_.data(); }
+    const T* data() const noexcept { return data_.data(); }
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+    auto begin() noexcept { return data_.begin(); }
+    auto end() noexcept { return data_.end(); }
+    auto begin() const noexcept { return data_.begin(); }
+    auto end() const noexcept { return data_.end(); }
+
+    // Element i of out only depends on element i of each operand, so
+    // out may alias an operand (a = a * 2 + b).
+    template <class E>
+    XLAB_EXPR_SIMD static void assign(T* out, E e, std::size_t n) {
+#pragma GCC ivdep
+        for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<T>(e[i]);
+    }
+
+private:
+    std::vector<T> data_;
+};
+
+// A Vec enters an expression as a Leaf; other nodes are copied as they are.
+template <class T>
+Leaf<T> as_node(const Vec<T>& v) {
+    return {v.data(), v.size()};
+}
+template <Expression E>
+const E& as_node(const E& e) {
+    return e;
+}
+template <Arithmetic T>
+Broadcast<T> as_node(T v) {
+    return {v};
+}
+
+template <class Op, class A, class B>
+auto make_binary(const A& a, const B& b) {
+    using L = std::remove_cvref_t<decltype(as_node(a))>;
+    using R = std::remove_cvref_t<decltype(as_node(b))>;
+    Binary<Op, L, R> node{as_node(a), as_node(b)};
+    if constexpr (!is_broadcast<L> && !is_broadcast<R>) {
+        if (node.l.size() != node.r.size()) throw std::invalid_argument("expr: operand sizes differ");
+    }
+    return node;
+}
+
+// An operator applies when at least one side is a vector expression.
+template <class A, class B>
+concept Operands = (Expression<A> && (Expression<B> || Arithmetic<B>)) || (Arithmetic<A> && Expression<B>);
+
+template <class A, class B>
+    requires Operands<A, B>
+auto operator+(const A& a, const B& b) {
+    return make_binary<std::plus<>>(a, b);
+}
+
+template <class A, class B>
+    requires Operands<A, B>
+auto operator-(const A& a, const B& b) {
+    return make_binary<std::minus<>>(a, b);
+}
+
+template <class A, class B>
+    requires Operands<A, B>
+auto operator*(const A& a, const B& b) {
+    return make_binary<std::multiplies<>>(a, b);
+}
+
+template <class A, class B>
+    requires Operands<A, B>
+auto operator/(const A& a, const B& b) {
+    return make_binary<std::divides<>>(a, b);
+}
+
+template <Expression E>
+auto operator-(const E& e) {
+    using N = std::remove_cvref_t<decltype(as_node(e))>;
+    return Unary<std::negate<>, N>{as_node(e)};
+}
+
+// =======================================================
+// add: the templateTypename.cpp template with the types left free
+// =======================================================
+template <Arithmetic A, Arithmetic B>
+std::common_type_t<A, B> add(A a, B b) {
+    return static_cast<std::common_type_t<A, B>>(a) + static_cast<std::common_type_t<A, B>>(b);
+}
+
+template <class A, class B>
+    requires Operands<A, B>
+auto add(const A& a, const B& b) {
+    return a + b;
+}
+
+} // namespace expr
@@ -0,0 +1,160 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "exprVector.hpp"
+
+/* Usage
+./app            # 10M elements
+./app 1000000    # other sizes
+
+Build: g++ -std=c++20 -O2 exprVectorBench.cpp -o app
+*/
+
+using Clock = std::chrono::steady_clock;
+
+// =======================================================
+// The naive version: add<T>-style operators on std::vector, one full
+// temporary per operator.
+// =======================================================
+namespace naive {
+
+static long temporaries = 0;
+
+template <class T>
+std::vector<T> operator+(const std::vector<T>& a, const std::vector<T>& b) {
+    ++temporaries;
+    std::vector<T> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = a[i] + b[i];
+    return r;
+}
+
+template <class T>
+std::vector<T> operator-(const std::vector<T>& a, const std::vector<T>& b) {
+    ++temporaries;
+    std::vector<T> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = a[i] - b[i];
+    return r;
+}
+
+template <class T>
+std::vector<T> operator*(const std::vector<T>& a, const std::vector<T>& b) {
+    ++temporaries;
+    std::vector<T> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = a[i] * b[i];
+    return r;
+}
+
+template <class T>
+std::vector<T> operator*(const std::vector<T>& a, T s) {
+    ++temporaries;
+    std::vector<T> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = a[i] * s;
+    return r;
+}
+
+// Mixed types need an explicit conversion pass first (add<double>(3, 2.5)).
+template <class To, class From>
+std::vector<To> convert(const std::vector<From>& a) {
+    ++temporaries;
+    return std::vector<To>(a.begin(), a.end());
+}
+
+} // namespace naive
+
+template <class F>
+static double best_ms(F f, int reps = 5) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    return best;
+}
+
+template <class A, class B>
+static void check_equal(const A& a, const B& b, const char* what) {
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::abs(double(a[i]) - double(b[i])) > 1e-9 * (1 + std::abs(double(a[i])))) {
+            std::fprintf(stderr, "MISMATCH %s at %zu\n", what, i);
+            std::exit(1);
+        }
+    }
+}
+
+static void report(const char* name, double ms, double bytes, long temps) {
+    std::printf("  %-36s %9.2f ms %8.2f GB/s %6ld temporaries\n", name, ms, bytes / ms / 1e6, temps);
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+    using naive::operator+, naive::operator-, naive::operator*;
+
+    std::vector<double> a(n), b(n), c(n), d(n);
+    std::vector<int> ai(n);
+    std::vector<float> bf(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = 0.5 * double(i % 1000);
+        b[i] = 1.0 + double(i % 7);
+        c[i] = 2.0 - double(i % 3);
+        d[i] = double(i % 11);
+        ai[i] = int(i % 1000) - 500;
+        bf[i] = 0.25f * float(i % 13);
+    }
+    expr::Vec<double> ea(n), eb(n), ec(n), ed(n);
+    expr::Vec<int> eai(n);
+    expr::Vec<float> ebf(n);
+    std::copy(a.begin(), a.end(), ea.begin());
+    std::copy(b.begin(), b.end(), eb.begin());
+    std::copy(c.begin(), c.end(), ec.begin());
+    std::copy(d.begin(), d.end(), ed.begin());
+    std::copy(ai.begin(), ai.end(), eai.begin());
+    std::copy(bf.begin(), bf.end(), ebf.begin());
+
+    // -------------------------------------------------------
+    std::printf("\n[r = a + b * c - d] %zu doubles\n", n);
+    // Minimum traffic: 4 reads + 1 write per element.
+    const double bytes = 5.0 * sizeof(double) * double(n);
+
+    std::vector<double> naive_r;
+    naive::temporaries = 0;
+    const double naive_ms = best_ms([&] { naive_r = a + b * c - d; });
+    report("naive operators (std::vector)", naive_ms, bytes, naive::temporaries / 5);
+
+    std::vector<double> loop_r(n);
+    const double loop_ms = best_ms([&] {
+        for (std::size_t i = 0; i < n; ++i) loop_r[i] = a[i] + b[i] * c[i] - d[i];
+    });
+    report("hand-written loop", loop_ms, bytes, 0);
+
+    expr::Vec<double> er(n);
+    const double expr_ms = best_ms([&] { er = ea + eb * ec - ed; });
+    report("expr::Vec (fused, SIMD)", expr_ms, bytes, 0);
+    check_equal(naive_r, er, "a + b * c - d");
+    check_equal(loop_r, er, "a + b * c - d (loop)");
+    std::printf("  speedup vs naive: %.2fx\n", naive_ms / expr_ms);
+
+    // -------------------------------------------------------
+    std::printf("\n[r = ai + bf * 2.5 - a] int + float * double - double, %zu elements\n", n);
+    const double mixed_bytes = double(sizeof(int) + sizeof(float) + 2 * sizeof(double)) * double(n);
+
+    naive::temporaries = 0;
+    const double naive_mixed_ms = best_ms([&] {
+        naive_r = naive::convert<double>(ai) + naive::convert<double>(bf) * 2.5 - a;
+    });
+    report("naive (convert + operators)", naive_mixed_ms, mixed_bytes, naive::temporaries / 5);
+
+    const double expr_mixed_ms = best_ms([&] { er = eai + ebf * 2.5 - ea; });
+    report("expr::Vec (promoted at compile time)", expr_mixed_ms, mixed_bytes, 0);
+    check_equal(naive_r, er, "mixed");
+    std::printf("  speedup vs naive: %.2fx\n", naive_mixed_ms / expr_mixed_ms);
+
+    static_assert(std::is_same_v<decltype(expr::add(3, 2.5)), double>);
+    static_assert(std::is_same_v<decltype(eai + ebf * 2.5)::value_type, double>);
+    std::printf("\nexpr::add(3, 2.5) = %g\n", expr::add(3, 2.5));
+    return 0;
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// =======================================================
+// inplace_function / function_ref
+//   CASE 12 in lambda.cpp stores callbacks in std::function, which
+//   type-erases "with some overhead": a capture bigger than its small
+//   buffer (16 bytes in libstdc++) is heap-allocated, and a move-only
+//   capture (CASE 7's unique_ptr) is rejected outright.
+//
+//   inplace_function<R(Args...), Capacity>
+//     - owns the callable in a Capacity-byte buffer inside the object;
+//       never allocates. A callable that does not fit is a compile error.
+//     - move-only, so move-only captures are fine.
+//     - calling an empty one throws std::bad_function_call.
+//
+//   function_ref<R(Args...)>
+//     - two pointers, does not own: for "take a callback as a parameter".
+//     - the callable must outlive the ref (same trap as CASE 15); plain
+//       functions and function pointers are copied in, so `= &g` is fine.
+//   Both accept a callable whose result converts to R; R = void drops it.
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall inplaceFunctionBench.cpp
+// =======================================================
+
+namespace fn {
+
+constexpr std::size_t kDefaultCapacity = 32;
+
+namespace detail {
+
+// std::invoke_r before C++23: R = void discards the result, like std::function.
+template <class R, class F, class... Args>
+constexpr R invoke_r(F&& f, Args&&... args) {
+    if constexpr (std::is_void_v<R>) {
+        std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    } else {
+        return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+}
+
+} // namespace detail
+
+template <class Sig, std::size_t Capacity = kDefaultCapacity, std::size_t Align = alignof(std::max_align_t)>
+class inplace_function;
+
+template <class T>
+struct is_inplace_function : std::false_type {};
+template <class Sig, std::size_t C, std::size_t A>
+struct is_inplace_function<inplace_function<Sig, C, A>> : std::true_type {};
+
+template <class R, class... Args, std::size_t Capacity, std::size_t Align>
+class inplace_function<R(Args...), Capacity, Align> {
+    // One static table per stored type; the object holds a pointer to it.
+    struct VTable {
+        R (*invoke)(void*, Args&&...);
+        void (*move)(void* dst, void* src) noexcept;   // move-construct dst, destroy src
+        void (*destroy)(void*) noexcept;
+    };
+
+    static constexpr VTable kEmpty{
+        [](void*, Args&&...) -> R { throw std::bad_function_call(); },
+        [](void*, void*) noexcept {},
+        [](void*) noexcept {},
+    };
+
+    template <class F>
+    static constexpr VTable kTable{
+        [](void* p, Args&&... args) -> R {
+            return detail::invoke_r<R>(*static_cast<F*>(p), std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        },
+        [](void* p) noexcept { static_cast<F*>(p)->~F(); },
+    };
+
+public:
+    static constexpr std::size_t capacity = Capacity;
+
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    template <class F, class D = std::decay_t<F>>
+        requires(!is_inplace_function<D>::value && std::is_invocable_r_v<R, D&, Args...>)
+    inplace_function(F&& f) {
+        static_assert(sizeof(D) <= Capacity, "callable does not fit: raise Capacity");
+        static_assert(Align % alignof(D) == 0, "callable is over-aligned for this inplace_function");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "callable must be nothrow-movable");
+        ::new (static_cast<void*>(buf_)) D(std::forward<F>(f));
+        vt_ = &kTable<D>;
+    }
+
+    inplace_function(inplace_function&& o) noexcept : vt_(o.vt_) {
+        vt_->move(buf_, o.buf_);
+        o.vt_ = &kEmpty;
+    }
+
+    inplace_function& operator=(inplace_function&& o) noexcept {
+        if (this != &o) {
+            vt_->destroy(buf_);
+            vt_ = o.vt_;
+            vt_->move(buf_, o.buf_);
+            o.vt_ = &kEmpty;
+        }
+        return *this;
+    }
+
+    inplace_function& operator=(std::nullptr_t) noexcept {
+        vt_->destroy(buf_);
+        vt_ = &kEmpty;
+        return *this;
+    }
+
+    template <class F>
+        requires(!is_inplace_function<std::decay_t<F>>::value)
+    inplace_function& operator=(F&& f) {
+        return *this = inplace_function(std::forward<F>(f));
+    }
+
+    inplace_function(const inplace_function&) = delete;
+    inplace_function& operator=(const inplace_function&) = delete;
+
+    ~inplace_function() { vt_->destroy(buf_); }
+
+    // Like std::function, const-callable even if the target is mutable.
+    R operator()(Args... args) const { return vt_->invoke(const_cast<std::byte*>(buf_), std::forward<Args>(args)...); }
+
+    explicit operator bool() const noexcept { return vt_ != &kEmpty; }
+
+private:
+    const VTable* vt_ = &kEmpty;
+    alignas(Align) std::byte buf_[Capacity];
+};
+
+// =======================================================
+// function_ref: non-owning view of a callable
+// =======================================================
+template <class Sig>
+class function_ref;
+
+template <class R, class... Args>
+class function_ref<R(Args...)> {
+public:
+    template <class F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, function_ref> && std::is_invocable_r_v<R, F&, Args...>)
+    function_ref(F&& f) noexcept {
+        using T = std::remove_cvref_t<F>;
+        if constexpr (std::is_function_v<T> || std::is_function_v<std::remove_pointer_t<T>>) {
+            // Functions and function pointers are kept by value: `= &g` is a
+            // temporary pointer, whose address would dangle.
+            using Fp = std::add_pointer_t<std::remove_pointer_t<T>>;
+            target_.fn = reinterpret_cast<void (*)()>(static_cast<Fp>(f));
+            call_ = [](Target t, Args&&... args) -> R {
+                return detail::invoke_r<R>(reinterpret_cast<Fp>(t.fn), std::forward<Args>(args)...);
+            };
+        } else {
+            target_.obj = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+            call_ = [](Target t, Args&&... args) -> R {
+                return detail::invoke_r<R>(*static_cast<std::remove_reference_t<F>*>(t.obj),
+                                           std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    R operator()(Args... args) const { return call_(target_, std::forward<Args>(args)...); }
+
+private:
+    // Object address, or the function pointer itself.
+    union Target {
+        void* obj;
+        void (*fn)();
+    };
+    Target target_;
+    R (*call_)(Target, Args&&...);
+};
+
+} // namespace fn
@@ -0,0 +1,225 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "inplaceFunction.hpp"
+
+/* Usage
+./app    # construction cost + allocations, then call latency
+
+Build: g++ -std=c++20 -O2 inplaceFunctionBench.cpp -o app
+*/
+
+// =======================================================
+// Global allocation counter (this program only)
+// =======================================================
+static std::atomic<std::uint64_t> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using Clock = std::chrono::steady_clock;
+
+template <class T>
+static void do_not_optimize(T& v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+// =======================================================
+// 1) Construction: ns and heap allocations per wrapper built
+// =======================================================
+constexpr int kBuild = 1'000'000;
+
+template <class Make>
+static void report_build(const char* wrapper, const char* capture, std::size_t bytes, Make make) {
+    const auto a0 = g_allocs.load();
+    auto t0 = Clock::now();
+    for (int i = 0; i < kBuild; ++i) {
+        auto f = make(i);
+        do_not_optimize(f);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / kBuild;
+    const double allocs = double(g_allocs.load() - a0) / kBuild;
+    std::printf("  %-22s %-26s %6zu %10.1f %10.2f\n", wrapper, capture, bytes, ns, allocs);
+}
+
+static void bench_build() {
+    std::printf("\n[construct + destroy] %d times\n", kBuild);
+    std::printf("  %-22s %-26s %6s %10s %10s\n", "wrapper", "capture", "bytes", "ns", "allocs");
+
+    using StdFn = std::function<int(int)>;
+    using InFn = fn::inplace_function<int(int), 48>;
+
+    // 8 bytes: fits everywhere.
+    report_build("auto", "[int]", 8, [](int i) { return [i](int x) { return x + i; }; });
+    report_build("std::function", "[int]", 8, [](int i) { return StdFn([i](int x) { return x + i; }); });
+    report_build("inplace_function<48>", "[int]", 8, [](int i) { return InFn([i](int x) { return x + i; }); });
+
+    // 32 bytes: past std::function's 16-byte small buffer.
+    struct Four {
+        std::int64_t a, b, c, d;
+    };
+    report_build("auto", "[Four]", sizeof(Four), [](int i) {
+        return [v = Four{i, i, i, i}](int x) { return int(x + v.a + v.d); };
+    });
+    report_build("std::function", "[Four]", sizeof(Four), [](int i) {
+        return StdFn([v = Four{i, i, i, i}](int x) { return int(x + v.a + v.d); });
+    });
+    report_build("inplace_function<48>", "[Four]", sizeof(Four), [](int i) {
+        return InFn([v = Four{i, i, i, i}](int x) { return int(x + v.a + v.d); });
+    });
+
+    // CASE 7: a moved-in unique_ptr. std::function needs a copyable target,
+    // so the usual workaround is shared_ptr (one more allocation).
+    report_build("auto", "[ptr = move(unique_ptr)]", sizeof(void*), [](int i) {
+        return [ptr = std::make_unique<int>(i)](int x) { return x + *ptr; };
+    });
+    report_build("std::function", "[shared_ptr] (workaround)", sizeof(std::shared_ptr<int>), [](int i) {
+        return StdFn([ptr = std::make_shared<int>(i)](int x) { return x + *ptr; });
+    });
+    report_build("inplace_function<48>", "[ptr = move(unique_ptr)]", sizeof(void*), [](int i) {
+        return InFn([ptr = std::make_unique<int>(i)](int x) { return x + *ptr; });
+    });
+    std::printf("  (unique_ptr rows include the make_unique/make_shared of the int itself)\n");
+}
+
+// =======================================================
+// 2) Call latency: 1M stored callbacks, call each once per pass
+// =======================================================
+constexpr int kCallbacks = 1'000'000;
+constexpr int kPasses = 20;
+
+template <class Call>
+static void report_call(const char* wrapper, std::size_t sizeof_each, Call call) {
+    std::int64_t sum = 0;
+    auto t0 = Clock::now();
+    for (int p = 0; p < kPasses; ++p) sum += call();
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (double(kPasses) * kCallbacks);
+    std::printf("  %-28s %10zu %10.2f   (sum %lld)\n", wrapper, sizeof_each, ns, static_cast<long long>(sum));
+}
+
+// Two different targets, interleaved, so the indirect call is not trivially
+// predicted to a single address.
+struct AddK {
+    int k;
+    int operator()(int x) const { return x + k; }
+};
+struct MulK {
+    int k;
+    int operator()(int x) const { return x * k; }
+};
+
+static void bench_call() {
+    std::printf("\n[call] %d callbacks x %d passes\n", kCallbacks, kPasses);
+    std::printf("  %-28s %10s %10s\n", "wrapper", "sizeof", "ns/call");
+
+    {
+        // auto: one concrete type, calls inline; the baseline.
+        std::vector<AddK> v;
+        for (int i = 0; i < kCallbacks; ++i) v.push_back(AddK{i & 7});
+        report_call("auto (AddK, inlined)", sizeof(AddK), [&] {
+            std::int64_t s = 0;
+            for (const auto& f : v) s += f(1);
+            return s;
+        });
+    }
+    {
+        std::vector<std::function<int(int)>> v;
+        for (int i = 0; i < kCallbacks; ++i) {
+            if (i & 1) v.emplace_back(AddK{i & 7});
+            else v.emplace_back(MulK{i & 7});
+        }
+        report_call("std::function", sizeof(v[0]), [&] {
+            std::int64_t s = 0;
+            for (const auto& f : v) s += f(1);
+            return s;
+        });
+    }
+    {
+        std::vector<fn::inplace_function<int(int), 16>> v;
+        v.reserve(kCallbacks);
+        for (int i = 0; i < kCallbacks; ++i) {
+            if (i & 1) v.emplace_back(AddK{i & 7});
+            else v.emplace_back(MulK{i & 7});
+        }
+        report_call("inplace_function<16>", sizeof(v[0]), [&] {
+            std::int64_t s = 0;
+            for (const auto& f : v) s += f(1);
+            return s;
+        });
+    }
+    {
+        std::vector<AddK> adds;
+        std::vector<MulK> muls;
+        for (int i = 0; i < kCallbacks / 2; ++i) {
+            adds.push_back(AddK{i & 7});
+            muls.push_back(MulK{i & 7});
+        }
+        std::vector<fn::function_ref<int(int)>> v;
+        v.reserve(kCallbacks);
+        for (int i = 0; i < kCallbacks / 2; ++i) {
+            v.emplace_back(muls[i]);
+            v.emplace_back(adds[i]);
+        }
+        report_call("function_ref", sizeof(v[0]), [&] {
+            std::int64_t s = 0;
+            for (const auto& f : v) s += f(1);
+            return s;
+        });
+    }
+}
+
+// =======================================================
+// 3) Signatures std::function accepts: a void(int) wrapper around an
+//    int-returning callable (the result is dropped), and function_ref bound
+//    to a function pointer prvalue (`= &twice`, a temporary).
+// =======================================================
+static int g_calls = 0;
+static int twice(int x) {
+    ++g_calls;
+    return x * 2;
+}
+
+static void check_signatures() {
+    std::function<void(int)> s = [](int x) { return x * 2; };
+    fn::inplace_function<void(int)> f = [](int x) { ++g_calls; return x * 2; };
+    fn::function_ref<void(int)> r = twice;
+    fn::function_ref<void(int)> vp = &twice;
+    fn::function_ref<int(int)> p = &twice;  // the pointer is stored, not its address
+    s(1);
+    f(1);
+    r(1);
+    vp(1);
+    if (p(21) != 42 || g_calls != 4) std::abort();
+    std::printf("\nvoid(int) over int-returning callables, function_ref = &fn: OK\n");
+}
+
+int main() {
+    bench_build();
+    bench_call();
+    check_signatures();
+
+    // Allocation check for the steady state: moving and calling inplace_functions.
+    fn::inplace_function<int(int), 48> a([ptr = std::make_unique<int>(1)](int x) { return x + *ptr; });
+    const auto before = g_allocs.load();
+    for (int i = 0; i < 1000; ++i) {
+        auto b = std::move(a);
+        a = std::move(b);
+        if (a(i) != i + 1) std::abort();
+    }
+    std::printf("\ninplace_function move/call x1000: %llu allocations\n",
+                static_cast<unsigned long long>(g_allocs.load() - before));
+    return 0;
+}
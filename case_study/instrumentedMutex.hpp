@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "shardedStats.hpp"
+
+// =======================================================
+// Instrumented mutex / guard
+//   Same RAII idea as ManualLockGuard in destructorCases.cpp, but every
+//   acquisition is attributed to a named lock site and records:
+//     - wait time (0 when try_lock succeeds right away)
+//     - hold time (lock -> unlock)
+//     - contention count (acquisitions that had to block)
+//
+//   Each thread writes only its own per-site histograms (plain load+store
+//   on relaxed atomics, no lock prefix), and an uncontended acquisition
+//   reads the clock only for 1 in kHoldSampleEvery holds, so the
+//   uncontended path is a try_lock plus a few stores. Contended
+//   acquisitions are always timed. dump() sums all threads on demand.
+//
+//   instrumented::Mutex m("orders.book");          // one site per mutex
+//   { instrumented::Guard g(m); ... }
+//   { instrumented::Guard g(m, XLAB_LOCK_SITE("flush")); ... }  // per call site
+//   instrumented::dump(std::cout);
+//
+// Build (example, C++20 for <bit>):
+//   g++ -std=c++20 -O2 -Wall mutexTest.cpp -pthread
+// =======================================================
+
+namespace instrumented {
+
+constexpr std::size_t kMaxSites = 256;
+
+// Uncontended holds are timed once every N acquisitions per thread and
+// site (a timestamp read is 10-40 ns on some VMs). Power of two.
+constexpr std::uint32_t kHoldSampleEvery = 16;
+static_assert(std::has_single_bit(kHoldSampleEvery), "kHoldSampleEvery must be a power of two");
+
+// Cheap timestamp: TSC ticks on x86, steady_clock ns elsewhere.
+inline std::uint64_t now_ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Calibrated once, on the first dump.
+inline double ticks_per_ns() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const double rate = [] {
+        auto t0 = std::chrono::steady_clock::now();
+        std::uint64_t c0 = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::uint64_t c1 = __rdtsc();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        return static_cast<double>(c1 - c0) / ns;
+    }();
+    return rate;
+#else
+    return 1.0;
+#endif
+}
+
+// Single-writer log2 histogram: only the owning thread calls record(), any
+// thread may read. Buckets match sharded::HistogramSnapshot.
+class LocalHistogram {
+public:
+    void record(std::uint64_t v) noexcept {
+        bump(buckets_[static_cast<std::size_t>(std::bit_width(v))], 1);
+        bump(sum_, v);
+        if (v > max_.load(std::memory_order_relaxed)) max_.store(v, std::memory_order_relaxed);
+    }
+
+    // Zero-valued sample without touching sum/max (uncontended wait).
+    void record_zero() noexcept { bump(buckets_[0], 1); }
+
+    void add_to(sharded::HistogramSnapshot& out) const noexcept {
+        for (std::size_t b = 0; b < sharded::HistogramSnapshot::kBuckets; ++b) {
+            std::uint64_t n = buckets_[b].load(std::memory_order_relaxed);
+            out.buckets[b] += n;
+            out.count += n;
+        }
+        out.sum += sum_.load(std::memory_order_relaxed);
+        out.max = std::max(out.max, max_.load(std::memory_order_relaxed));
+    }
+
+private:
+    static void bump(std::atomic<std::uint64_t>& a, std::uint64_t n) noexcept {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, sharded::HistogramSnapshot::kBuckets> buckets_{};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// One thread's numbers for one site.
+struct alignas(sharded::kCacheLine) SiteStats {
+    LocalHistogram wait;   // ticks
+    LocalHistogram hold;   // ticks; sampled when uncontended
+    std::atomic<std::uint64_t> contended{0};
+    std::uint32_t sample = 0;  // owner thread only
+};
+
+struct LockSite {
+    std::string name;
+    const char* file = nullptr;
+    int line = 0;
+    std::size_t index = kMaxSites;  // kMaxSites: registry full, not recorded
+};
+
+// Per-thread table of SiteStats, indexed by LockSite::index. Tables are
+// never freed: a table whose thread exited is handed to the next new
+// thread, so its counts stay in the totals.
+struct ThreadTable {
+    std::array<std::atomic<SiteStats*>, kMaxSites> sites{};
+    std::vector<std::unique_ptr<SiteStats>> owned;  // owner thread only
+    std::atomic<bool> in_use{false};
+
+    SiteStats* stats(std::size_t index) {
+        SiteStats* s = sites[index].load(std::memory_order_relaxed);
+        if (s) return s;
+        owned.push_back(std::make_unique<SiteStats>());
+        s = owned.back().get();
+        sites[index].store(s, std::memory_order_release);
+        return s;
+    }
+};
+
+class Registry {
+public:
+    // Find-or-create by name; the registry owns sites for the whole run.
+    LockSite& site(const std::string& name, const char* file = nullptr, int line = 0) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& s : sites_) {
+            if (s->name == name && s->file == file && s->line == line) return *s;
+        }
+        sites_.push_back(std::make_unique<LockSite>(LockSite{name, file, line, kMaxSites}));
+        LockSite& s = *sites_.back();
+        if (sites_.size() <= kMaxSites) s.index = sites_.size() - 1;
+        return s;
+    }
+
+    ThreadTable* claim_table() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& t : tables_) {
+            bool expected = false;
+            if (t->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) return t.get();
+        }
+        tables_.push_back(std::make_unique<ThreadTable>());
+        tables_.back()->in_use.store(true, std::memory_order_relaxed);
+        return tables_.back().get();
+    }
+
+    struct SiteReport {
+        const LockSite* site;
+        std::uint64_t contended = 0;
+        sharded::HistogramSnapshot wait;  // ticks
+        sharded::HistogramSnapshot hold;  // ticks
+    };
+
+    std::vector<SiteReport> collect() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::vector<SiteReport> out;
+        for (auto& s : sites_) {
+            if (s->index == kMaxSites) continue;
+            SiteReport r{s.get(), 0, {}, {}};
+            for (auto& t : tables_) {
+                const SiteStats* st = t->sites[s->index].load(std::memory_order_acquire);
+                if (!st) continue;
+                st->wait.add_to(r.wait);
+                st->hold.add_to(r.hold);
+                r.contended += st->contended.load(std::memory_order_relaxed);
+            }
+            out.push_back(r);
+        }
+        return out;
+    }
+
+    std::size_t dropped_sites() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return sites_.size() > kMaxSites ? sites_.size() - kMaxSites : 0;
+    }
+
+private:
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<LockSite>> sites_;
+    std::vector<std::unique_ptr<ThreadTable>> tables_;
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+inline ThreadTable* claim_thread_table() {
+    struct Handle {
+        ThreadTable* table = registry().claim_table();
+        ~Handle() { table->in_use.store(false, std::memory_order_release); }
+    };
+    thread_local Handle handle;
+    return handle.table;
+}
+
+inline SiteStats* thread_stats(const LockSite& site) {
+    // Trivial thread_local: no init guard on the hot path.
+    thread_local ThreadTable* table = nullptr;
+    if (!table) [[unlikely]] table = claim_thread_table();
+    return table->stats(site.index);
+}
+
+// Lock site bound to the source location of the guard, created once.
+#define XLAB_LOCK_SITE(name) \
+    ([]() -> ::instrumented::LockSite& { \
+        static ::instrumented::LockSite& s = ::instrumented::registry().site(name, __FILE__, __LINE__); \
+        return s; \
+    }())
+
+// =======================================================
+// Mutex: BasicLockable/Lockable, so std::lock_guard and std::unique_lock
+// work too (attributed to the mutex's own site).
+// =======================================================
+class Mutex {
+public:
+    Mutex() : Mutex("(unnamed)") {}
+    explicit Mutex(const std::string& name) : site_(&registry().site(name)) {}
+
+    Mutex(const Mutex&) = delete;
+    Mutex& operator=(const Mutex&) = delete;
+
+    void lock() { lock(*site_); }
+
+    void lock(const LockSite& site) {
+        if (site.index == kMaxSites) {
+            mtx_.lock();
+            held_ = nullptr;
+            return;
+        }
+        SiteStats* stats = thread_stats(site);
+        if (mtx_.try_lock()) {
+            stats->wait.record_zero();
+            acquired_ = (++stats->sample & (kHoldSampleEvery - 1)) == 0 ? now_ticks() : 0;
+        } else {
+            const std::uint64_t t0 = now_ticks();
+            mtx_.lock();
+            acquired_ = now_ticks();
+            stats->wait.record(acquired_ - t0);
+            stats->contended.store(stats->contended.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        held_ = stats;
+    }
+
+    bool try_lock() {
+        if (!mtx_.try_lock()) return false;
+        held_ = nullptr;
+        if (site_->index != kMaxSites) {
+            held_ = thread_stats(*site_);
+            held_->wait.record_zero();
+            acquired_ = (++held_->sample & (kHoldSampleEvery - 1)) == 0 ? now_ticks() : 0;
+        }
+        return true;
+    }
+
+    void unlock() {
+        SiteStats* stats = held_;
+        const std::uint64_t acquired = acquired_;
+        mtx_.unlock();
+        // Recorded after unlock so the bookkeeping is not inside the critical section.
+        if (stats && acquired) stats->hold.record(now_ticks() - acquired);
+    }
+
+    const LockSite& site() const noexcept { return *site_; }
+
+private:
+    std::mutex mtx_;
+    const LockSite* site_;
+    // Written only by the holder. acquired_ == 0: this hold is not timed.
+    SiteStats* held_ = nullptr;
+    std::uint64_t acquired_ = 0;
+};
+
+class Guard {
+public:
+    explicit Guard(Mutex& m) : m_(m) { m_.lock(); }
+    Guard(Mutex& m, const LockSite& site) : m_(m) { m_.lock(site); }
+    ~Guard() { m_.unlock(); }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+private:
+    Mutex& m_;
+};
+
+// Table of every site, hottest (most total wait) first. Times in ns;
+// percentiles are log2 bucket upper bounds (within 2x).
+inline void dump(std::ostream& os) {
+    auto reports = registry().collect();
+    std::sort(reports.begin(), reports.end(),
+              [](const auto& a, const auto& b) { return a.wait.sum > b.wait.sum; });
+
+    const double tpn = ticks_per_ns();
+    auto ns = [tpn](std::uint64_t ticks) { return static_cast<double>(ticks) / tpn; };
+
+    os << std::left << std::setw(28) << "lock site" << std::right
+       << std::setw(12) << "acquired" << std::setw(11) << "contended"
+       << std::setw(12) << "wait p50" << std::setw(12) << "wait p99" << std::setw(14) << "wait total"
+       << std::setw(12) << "hold p50" << std::setw(12) << "hold p99" << std::setw(12) << "hold max" << "\n";
+    os << std::fixed << std::setprecision(0);
+    for (const auto& r : reports) {
+        std::string name = r.site->name;
+        if (r.site->file) name += " @" + std::to_string(r.site->line);
+        const double pct = r.wait.count ? 100.0 * static_cast<double>(r.contended) / static_cast<double>(r.wait.count) : 0.0;
+        os << std::left << std::setw(28) << name << std::right
+           << std::setw(12) << r.wait.count << std::setprecision(1) << std::setw(10) << pct << "%"
+           << std::setprecision(0) << std::setw(12) << ns(r.wait.percentile(0.50)) << std::setw(12) << ns(r.wait.percentile(0.99))
+           << std::setw(14) << ns(r.wait.sum)
+           << std::setw(12) << ns(r.hold.percentile(0.50)) << std::setw(12) << ns(r.hold.percentile(0.99))
+           << std::setw(12) << ns(r.hold.max) << "\n";
+    }
+    os.unsetf(std::ios::fixed);
+    if (std::size_t dropped = registry().dropped_sites()) {
+        os << "(" << dropped << " sites over the " << kMaxSites << "-site limit were not recorded)\n";
+    }
+}
+
+} // namespace instrumented
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+
+#include "memoryPages.hpp"
+
+/* Usage
+./app                         # latency curve + bandwidth table + NUMA matrix
+./app latency 512MB           # pointer-chase latency, 4KB .. 512MB
+./app bandwidth 2GB 16        # read/write/copy GB/s, 1..16 threads, 2GB total
+./app numa 1GB                # local vs remote node read bandwidth
+
+Same allocation path as memoryOverflow.cpp (memoryPages.hpp: 2MB-aligned
+mmap + MADV_HUGEPAGE, first-touch commit) so TLB misses do not dominate.
+
+Build: g++ -std=c++20 -O2 memoryHierarchy.cpp -pthread -o app
+*/
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kLine = 64;
+
+static std::string format_size(std::size_t bytes) {
+    char buf[32];
+    if (bytes >= (1ULL << 30)) std::snprintf(buf, sizeof(buf), "%.4gGB", bytes / double(1ULL << 30));
+    else if (bytes >= (1ULL << 20)) std::snprintf(buf, sizeof(buf), "%.4gMB", bytes / double(1ULL << 20));
+    else std::snprintf(buf, sizeof(buf), "%.4gKB", bytes / 1024.0);
+    return buf;
+}
+
+static std::vector<int> allowed_cpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    std::vector<int> out;
+    for (int c = 0; c < CPU_SETSIZE; ++c) if (CPU_ISSET(c, &set)) out.push_back(c);
+    return out;
+}
+
+static void pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+// Runs body(i) on `cpus.size()` threads pinned to cpus[i], released together
+// after setup(i) finished on every thread; returns seconds for the body part.
+template <typename Setup, typename Body>
+static double pinned_run(const std::vector<int>& cpus, Setup setup, Body body) {
+    const unsigned n = static_cast<unsigned>(cpus.size());
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < n; ++i) {
+        pool.emplace_back([&, i] {
+            pin_to_cpu(cpus[i]);
+            setup(i);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(i);
+        });
+    }
+    while (ready.load() != n) std::this_thread::yield();
+    auto t0 = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : pool) t.join();
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// =======================================================
+// 1) Latency: dependent loads through a random cycle of cache lines
+//   (Sattolo's algorithm gives a single cycle, so every line is visited
+//   and the hardware prefetcher cannot guess the next address).
+// =======================================================
+static double chase_ns(std::size_t bytes) {
+    mem::Region r(bytes);
+    const std::size_t lines = std::max<std::size_t>(bytes / kLine, 2);
+    std::vector<std::uint32_t> order(lines);
+    std::iota(order.begin(), order.end(), 0u);
+    std::mt19937_64 rng(42);
+    for (std::size_t i = lines - 1; i > 0; --i) {
+        std::uniform_int_distribution<std::size_t> pick(0, i - 1);
+        std::swap(order[i], order[pick(rng)]);
+    }
+    for (std::size_t i = 0; i < lines; ++i) {
+        *reinterpret_cast<void**>(r.p + i * kLine) = r.p + static_cast<std::size_t>(order[i]) * kLine;
+    }
+
+    // Warm up one lap, then time at least ~50ms worth of loads.
+    void** p = reinterpret_cast<void**>(r.p);
+    for (std::size_t i = 0; i < lines; ++i) p = static_cast<void**>(*p);
+
+    std::size_t loads = 1 << 20;
+    double best = 1e30;
+    for (int rep = 0; rep < 3; ++rep) {
+        for (;;) {
+            auto t0 = Clock::now();
+            for (std::size_t i = 0; i < loads; i += 8) {
+                p = static_cast<void**>(*p); p = static_cast<void**>(*p);
+                p = static_cast<void**>(*p); p = static_cast<void**>(*p);
+                p = static_cast<void**>(*p); p = static_cast<void**>(*p);
+                p = static_cast<void**>(*p); p = static_cast<void**>(*p);
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+            if (ns < 5e7 && loads < (1ULL << 30)) { loads *= 2; continue; }
+            best = std::min(best, ns / static_cast<double>(loads));
+            break;
+        }
+    }
+    asm volatile("" : : "r"(p));
+    return best;
+}
+
+static void run_latency(std::size_t max_bytes) {
+    std::printf("\n[latency] pointer chase, random cycle of %zu-byte lines\n", kLine);
+    std::printf("%10s %10s\n", "size", "ns/load");
+    double first = 0.0;
+    for (std::size_t size = 4096; size <= max_bytes; ) {
+        const double ns = chase_ns(size);
+        if (first == 0.0) first = ns;
+        // Bar length ~ log ratio to the L1 latency: shows the cache steps.
+        int bar = static_cast<int>(std::max(0.0, 8.0 * std::log2(ns / first))) + 1;
+        std::printf("%10s %10.2f  %s\n", format_size(size).c_str(), ns, std::string(std::min(bar, 60), '#').c_str());
+        std::fflush(stdout);
+        // 1x, 1.5x per power of two.
+        size = (size & (size - 1)) == 0 ? size + size / 2 : (size / 3) * 4;
+    }
+}
+
+// =======================================================
+// 2) Bandwidth: read / write / copy, 1..N pinned threads, each on its own
+//   slice of one region (first-touched by its own thread).
+// =======================================================
+static std::uint64_t read_slice(const char* p, std::size_t bytes) {
+    const auto* q = reinterpret_cast<const std::uint64_t*>(p);
+    const std::size_t n = bytes / sizeof(std::uint64_t);
+    std::uint64_t a = 0, b = 0, c = 0, d = 0;
+    for (std::size_t i = 0; i + 4 <= n; i += 4) {
+        a += q[i]; b += q[i + 1]; c += q[i + 2]; d += q[i + 3];
+    }
+    return a + b + c + d;
+}
+
+enum class Op { Read, Write, Copy };
+
+// Every thread gets at least one huge page, so a total below threads * 2MB
+// is rounded up rather than measured over empty slices.
+static std::size_t slice_per_thread(std::size_t total, std::size_t threads) {
+    return std::max(mem::kHugePage, total / threads / mem::kHugePage * mem::kHugePage);
+}
+
+// Returns GB/s; copy counts bytes read + bytes written.
+static double measure_bw(const std::vector<int>& cpus, std::size_t total, Op op) {
+    const std::size_t n = cpus.size();
+    const std::size_t slice = slice_per_thread(total, n);
+    mem::Region r(slice * n);
+    std::atomic<std::uint64_t> sink{0};
+    int passes = 0;
+
+    auto setup = [&](unsigned i) { mem::touch_pages(r.p + i * slice, slice); };  // first touch: local node
+    double best = 0.0;
+    // Enough passes for ~0.2s per measurement.
+    for (passes = 1; ; passes *= 2) {
+        double s = pinned_run(cpus, setup, [&](unsigned i) {
+            char* mine = r.p + i * slice;
+            const std::size_t half = slice / 2;
+            for (int k = 0; k < passes; ++k) {
+                switch (op) {
+                    case Op::Read: sink.fetch_add(read_slice(mine, slice), std::memory_order_relaxed); break;
+                    case Op::Write: std::memset(mine, k, slice); break;
+                    case Op::Copy: std::memcpy(mine, mine + half, half); break;
+                }
+            }
+        });
+        // Copy moves slice/2 in and slice/2 out, so every op moves `slice` bytes.
+        const double bytes = static_cast<double>(slice) * n * passes;
+        best = std::max(best, bytes / s / 1e9);
+        if (s > 0.2 || passes >= 1024) break;
+    }
+    if (sink.load() == 42) std::puts("");
+    return best;
+}
+
+static void run_bandwidth(std::size_t total, unsigned max_threads) {
+    auto cpus = allowed_cpus();
+    max_threads = std::clamp<unsigned>(max_threads, 1, static_cast<unsigned>(cpus.size()));
+    std::printf("\n[bandwidth] %s total (at least 2MB per thread), threads pinned to distinct cpus\n",
+                format_size(total).c_str());
+    std::printf("%8s %12s %12s %12s\n", "threads", "read GB/s", "write GB/s", "copy GB/s");
+
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+    for (unsigned t : counts) {
+        std::vector<int> use(cpus.begin(), cpus.begin() + t);
+        std::printf("%8u %12.2f %12.2f %12.2f\n", t, measure_bw(use, total, Op::Read),
+                    measure_bw(use, total, Op::Write), measure_bw(use, total, Op::Copy));
+        std::fflush(stdout);
+    }
+}
+
+// =======================================================
+// 3) NUMA: memory first-touched by a thread on node M, read by all cpus of
+//   node C. Uses /sys only (no libnuma); placement relies on the default
+//   first-touch policy.
+// =======================================================
+static std::vector<int> parse_cpulist(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part.empty()) continue;
+        auto dash = part.find('-');
+        int lo = std::stoi(part.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+        for (int c = lo; c <= hi; ++c) out.push_back(c);
+    }
+    return out;
+}
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;  // allowed for this process
+};
+
+static std::vector<NumaNode> numa_nodes() {
+    auto allowed = allowed_cpus();
+    std::vector<NumaNode> nodes;
+    for (int node = 0; node < 1024; ++node) {  // node ids may be sparse
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in) continue;
+        std::string line;
+        std::getline(in, line);
+        std::vector<int> cpus;
+        for (int c : parse_cpulist(line)) {
+            if (std::find(allowed.begin(), allowed.end(), c) != allowed.end()) cpus.push_back(c);
+        }
+        if (!cpus.empty()) nodes.push_back({node, cpus});
+    }
+    return nodes;
+}
+
+static void run_numa(std::size_t bytes) {
+    auto nodes = numa_nodes();
+    std::printf("\n[numa] read GB/s, rows: cpus of node, columns: memory of node\n");
+    if (nodes.size() < 2) {
+        std::printf("  %zu NUMA node(s) usable by this process: nothing to compare\n", nodes.size());
+        return;
+    }
+    std::printf("%10s", "");
+    for (const auto& m : nodes) std::printf("   mem%-6d", m.id);
+    std::printf("\n");
+
+    for (std::size_t c = 0; c < nodes.size(); ++c) {
+        std::printf("  cpus%-4d", nodes[c].id);
+        for (std::size_t m = 0; m < nodes.size(); ++m) {
+            const auto& readers = nodes[c].cpus;
+            const std::size_t slice = slice_per_thread(bytes, readers.size());
+            mem::Region r(slice * readers.size());
+            // Commit from one cpu of node m, so every page lands there.
+            std::thread([&] { pin_to_cpu(nodes[m].cpus[0]); mem::touch_pages(r.p, r.bytes); }).join();
+
+            std::atomic<std::uint64_t> sink{0};
+            double best = 0.0;
+            for (int passes = 1; ; passes *= 2) {
+                double s = pinned_run(readers, [](unsigned) {}, [&](unsigned i) {
+                    for (int k = 0; k < passes; ++k)
+                        sink.fetch_add(read_slice(r.p + i * slice, slice), std::memory_order_relaxed);
+                });
+                best = std::max(best, static_cast<double>(slice) * readers.size() * passes / s / 1e9);
+                if (s > 0.2 || passes >= 1024) break;
+            }
+            std::printf(" %9.2f%s", best, c == m ? "*" : " ");
+            std::fflush(stdout);
+        }
+        std::printf("\n");
+    }
+    std::printf("  (* = local)\n");
+}
+
+int main(int argc, char** argv) {
+    const std::string mode = (argc > 1) ? argv[1] : "all";
+    try {
+        const unsigned hw = static_cast<unsigned>(allowed_cpus().size());
+        if (mode == "latency" || mode == "all") {
+            run_latency((argc > 2 && mode != "all") ? mem::parse_size(argv[2]) : 256ULL << 20);
+        }
+        if (mode == "bandwidth" || mode == "all") {
+            std::size_t total = (argc > 2 && mode != "all") ? mem::parse_size(argv[2]) : 1ULL << 30;
+            unsigned threads = (argc > 3 && mode != "all") ? static_cast<unsigned>(std::stoul(argv[3])) : hw;
+            run_bandwidth(total, threads);
+        }
+        if (mode == "numa" || mode == "all") {
+            run_numa((argc > 2 && mode != "all") ? mem::parse_size(argv[2]) : 1ULL << 30);
+        }
+        if (mode != "all" && mode != "latency" && mode != "bandwidth" && mode != "numa") {
+            std::cerr << "Usage: " << argv[0] << " [all | latency [max] | bandwidth [total] [threads] | numa [size]]\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
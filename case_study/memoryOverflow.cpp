@@ -1,58 +1,250 @@
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <new>
 
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "memoryPages.hpp"
+#include "threadPool.hpp"
+
 /* Usage
 ./app 10GB
 ./app 20GB
 ./app 5GB
+./app 8GB 256MB 0 --mode=populate              # mmap + MAP_POPULATE
+./app 8GB 256MB 0 --mode=thp --threads=8       # THP via madvise, 8 threads touching
+./app 8GB 1GB 0 --mode=hugetlb --no-wait       # needs vm.nr_hugepages reserved
+./app 64GB 256MB 1 --margin=512MB --json=t.json  # stop 512MB below the cgroup limit
+
+Build: g++ -std=c++20 -O2 memoryOverflow.cpp -pthread -o app
 */
 
+enum class Mode { New, Mmap, Populate, HugeTlb, Thp };
+
 struct Config {
     std::size_t target_bytes = 10ULL * 1024 * 1024 * 1024; // <-- change default here (10GB -> 20GB)
     std::size_t chunk_bytes  = 64ULL * 1024 * 1024;        // 64MB per chunk
     bool leak = true;                                      // true = leak, false = free
+    Mode mode = Mode::New;
+    unsigned threads = 1;                                  // threads touching pages
+    bool wait = true;                                      // wait for Enter before exit
+    std::size_t margin = 0;                                // 0: no cgroup safety stop
+    std::string json_path;                                 // per-chunk timeline
+};
+
+static const char* mode_name(Mode m) {
+    switch (m) {
+        case Mode::New: return "new";
+        case Mode::Mmap: return "mmap";
+        case Mode::Populate: return "populate";
+        case Mode::HugeTlb: return "hugetlb";
+        case Mode::Thp: return "thp";
+    }
+    return "?";
+}
+
+static Mode parse_mode(const std::string& s) {
+    for (Mode m : {Mode::New, Mode::Mmap, Mode::Populate, Mode::HugeTlb, Mode::Thp}) {
+        if (s == mode_name(m)) return m;
+    }
+    throw std::runtime_error("Unknown mode " + s + " (new | mmap | populate | hugetlb | thp)");
+}
+
+// One allocated chunk; released according to how it was allocated.
+struct Block {
+    char* p = nullptr;
+    std::size_t bytes = 0;   // mapped length (rounded up for huge pages)
+    Mode mode = Mode::New;
+
+    void release() {
+        if (!p) return;
+        if (mode == Mode::New) delete[] p;
+        else munmap(p, bytes);
+        p = nullptr;
+    }
 };
 
-// Parse strings like: "20GB", "512MB", "4096KB", "100B"
-static std::size_t parse_size(std::string s) {
-    // remove spaces
-    s.erase(std::remove_if(s.begin(), s.end(), ::isspace), s.end());
-    // uppercase
-    for (char& c : s) c = std::toupper(static_cast<unsigned char>(c));
-
-    // split number + unit
-    std::size_t i = 0;
-    while (i < s.size() && (std::isdigit(static_cast<unsigned char>(s[i])) || s[i] == '.')) i++;
-    if (i == 0) throw std::runtime_error("Size must start with a number (e.g., 20GB)");
-
-    double value = std::stod(s.substr(0, i));
-    std::string unit = s.substr(i);
-
-    std::size_t mult = 1;
-    if (unit.empty() || unit == "B") mult = 1;
-    else if (unit == "KB") mult = 1024ULL;
-    else if (unit == "MB") mult = 1024ULL * 1024;
-    else if (unit == "GB") mult = 1024ULL * 1024 * 1024;
-    else if (unit == "TB") mult = 1024ULL * 1024 * 1024 * 1024;
-    else throw std::runtime_error("Unknown unit. Use B/KB/MB/GB/TB (e.g., 20GB)");
-
-    return static_cast<std::size_t>(value * static_cast<double>(mult));
+// Returns a block whose p is nullptr when the system refused the allocation.
+static Block allocate(Mode mode, std::size_t bytes) {
+    Block b{nullptr, bytes, mode};
+    const int prot = PROT_READ | PROT_WRITE;
+    const int anon = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    switch (mode) {
+        case Mode::New:
+            b.p = new (std::nothrow) char[bytes];
+            return b;
+        case Mode::Mmap:
+        case Mode::Populate: {
+            // MAP_POPULATE: the kernel faults every page in before mmap returns.
+            void* p = mmap(nullptr, bytes, prot, anon | (mode == Mode::Populate ? MAP_POPULATE : 0), -1, 0);
+            b.p = p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+            return b;
+        }
+        case Mode::HugeTlb: {
+            // Comes from the reserved pool (vm.nr_hugepages); fails instead of falling back.
+            b.bytes = mem::round_up(bytes, mem::kHugePage);
+            void* p = mmap(nullptr, b.bytes, prot, anon | MAP_HUGETLB, -1, 0);
+            b.p = p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+            return b;
+        }
+        case Mode::Thp:
+            b.bytes = mem::round_up(bytes, mem::kHugePage);
+            b.p = mem::map_thp(b.bytes);
+            return b;
+    }
+    return b;
+}
+
+struct Faults {
+    long minor = 0;
+    long major = 0;
+};
+
+static Faults page_faults() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return {ru.ru_minflt, ru.ru_majflt};
+}
+
+// =======================================================
+// Telemetry sampled after every chunk
+// =======================================================
+
+// VmRSS / VmSwap / VmHWM / RssAnon from /proc/self/status, in kB.
+struct ProcStatus {
+    long rss_kb = -1;
+    long anon_kb = -1;
+    long swap_kb = -1;
+    long hwm_kb = -1;
+};
+
+static ProcStatus read_proc_status() {
+    ProcStatus st;
+    std::ifstream in("/proc/self/status");
+    std::string key;
+    long value = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        if (!(ls >> key >> value)) continue;
+        if (key == "VmRSS:") st.rss_kb = value;
+        else if (key == "RssAnon:") st.anon_kb = value;
+        else if (key == "VmSwap:") st.swap_kb = value;
+        else if (key == "VmHWM:") st.hwm_kb = value;
+    }
+    return st;
 }
 
-static void touch_pages(char* p, std::size_t bytes) {
-    const std::size_t page = 4096;
-    for (std::size_t i = 0; i < bytes; i += page) p[i] = 1; // commit pages
-    if (bytes) p[bytes - 1] = 1;
+static long long read_number_file(const std::string& path) {
+    std::ifstream in(path);
+    std::string v;
+    if (!(in >> v) || v == "max") return -1;
+    try { return std::stoll(v); } catch (...) { return -1; }
+}
+
+// Memory cgroup of this process: v2 (memory.max / memory.current) with a
+// v1 fallback (memory.limit_in_bytes / memory.usage_in_bytes). The
+// effective limit is the smallest one on the way up to the root. Inside a
+// cgroup namespace the path from /proc/self/cgroup may not exist under
+// /sys/fs/cgroup; then the mount root is our cgroup.
+struct CgroupMemory {
+    int version = 0;                   // 0: not found
+    std::string current_file;
+    std::vector<std::string> limit_files;
+
+    static CgroupMemory detect() {
+        CgroupMemory cg;
+        std::ifstream in("/proc/self/cgroup");
+        std::string line, v2_path, v1_path;
+        while (std::getline(in, line)) {
+            if (line.rfind("0::", 0) == 0) v2_path = line.substr(3);
+            auto mem = line.find(":memory:");
+            if (mem != std::string::npos) v1_path = line.substr(mem + 8);
+        }
+        auto exists = [](const std::string& f) { return static_cast<bool>(std::ifstream(f)); };
+        auto setup = [&](int version, std::string root, std::string path, const char* cur, const char* lim) {
+            if (!exists(root + path + "/" + cur)) path = "";
+            if (!exists(root + path + "/" + cur)) return false;
+            cg.version = version;
+            cg.current_file = root + path + "/" + cur;
+            for (;;) {
+                if (exists(root + path + "/" + lim)) cg.limit_files.push_back(root + path + "/" + lim);
+                if (path.empty() || path == "/") break;
+                path = path.substr(0, path.rfind('/'));
+            }
+            return true;
+        };
+        if (!setup(2, "/sys/fs/cgroup", v2_path, "memory.current", "memory.max"))
+            setup(1, "/sys/fs/cgroup/memory", v1_path, "memory.usage_in_bytes", "memory.limit_in_bytes");
+        return cg;
+    }
+
+    long long current() const { return version ? read_number_file(current_file) : -1; }
+
+    // -1: unlimited or unknown. v1 reports "unlimited" as a huge page-aligned number.
+    long long limit() const {
+        long long best = -1;
+        for (const auto& f : limit_files) {
+            long long v = read_number_file(f);
+            if (v < 0 || v >= (1LL << 62)) continue;
+            if (best < 0 || v < best) best = v;
+        }
+        return best;
+    }
+};
+
+struct Sample {
+    double t_s = 0;
+    std::size_t committed = 0;
+    double chunk_ms = 0;
+    double gbps = 0;
+    long minor = 0;
+    long major = 0;
+    ProcStatus status;
+    long long cg_current = -1;
+    long long cg_limit = -1;
+};
+
+static void write_json_sample(std::ostream& os, const Sample& s, bool first) {
+    os << (first ? "\n    " : ",\n    ")
+       << "{\"t_s\": " << s.t_s << ", \"committed_bytes\": " << s.committed
+       << ", \"chunk_ms\": " << s.chunk_ms << ", \"gb_per_s\": " << s.gbps
+       << ", \"minor_faults\": " << s.minor << ", \"major_faults\": " << s.major
+       << ", \"rss_kb\": " << s.status.rss_kb << ", \"rss_anon_kb\": " << s.status.anon_kb
+       << ", \"swap_kb\": " << s.status.swap_kb << ", \"hwm_kb\": " << s.status.hwm_kb
+       << ", \"cgroup_current\": " << s.cg_current << ", \"cgroup_limit\": " << s.cg_limit << "}";
+    os.flush();  // keep the timeline on disk even if we get OOM-killed next
 }
 
 static void print_usage(const char* prog) {
     std::cout
         << "Usage:\n"
-        << "  " << prog << " [target=10GB] [chunk=64MB] [leak=1|0]\n"
+        << "  " << prog << " [target=10GB] [chunk=64MB] [leak=1|0] [options]\n"
+        << "Options:\n"
+        << "  --mode=new|mmap|populate|hugetlb|thp   allocation mode (default new)\n"
+        << "       new       new char[] then touch\n"
+        << "       mmap      anonymous mmap then touch\n"
+        << "       populate  mmap + MAP_POPULATE (kernel commits, no touch)\n"
+        << "       hugetlb   mmap + MAP_HUGETLB (reserved 2MB pages) then touch\n"
+        << "       thp       2MB-aligned mmap + madvise(MADV_HUGEPAGE) then touch\n"
+        << "  --threads=N    threads touching pages (default 1)\n"
+        << "  --no-wait      exit without waiting for Enter\n"
+        << "  --margin=SIZE  stop before cgroup memory.current would come within SIZE of memory.max\n"
+        << "  --json=FILE    per-chunk timeline (time, RSS, swap, faults, cgroup usage)\n"
         << "Examples:\n"
         << "  " << prog << " 20GB 128MB 1   # leak up to 20GB in 128MB chunks\n"
         << "  " << prog << " 5GB  64MB  0   # allocate then free\n";
@@ -62,13 +254,25 @@ int main(int argc, char** argv) {
     Config cfg;
 
     try {
-        if (argc > 1) cfg.target_bytes = parse_size(argv[1]);
-        if (argc > 2) cfg.chunk_bytes  = parse_size(argv[2]);
-        if (argc > 3) cfg.leak         = (std::stoi(argv[3]) != 0);
-        if (argc > 4) { print_usage(argv[0]); return 1; }
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a.rfind("--mode=", 0) == 0) cfg.mode = parse_mode(a.substr(7));
+            else if (a.rfind("--threads=", 0) == 0) cfg.threads = static_cast<unsigned>(std::stoul(a.substr(10)));
+            else if (a == "--no-wait") cfg.wait = false;
+            else if (a.rfind("--margin=", 0) == 0) cfg.margin = mem::parse_size(a.substr(9));
+            else if (a.rfind("--json=", 0) == 0) cfg.json_path = a.substr(7);
+            else if (a.rfind("--", 0) == 0) throw std::runtime_error("Unknown option " + a);
+            else positional.push_back(a);
+        }
+        if (positional.size() > 0) cfg.target_bytes = mem::parse_size(positional[0]);
+        if (positional.size() > 1) cfg.chunk_bytes  = mem::parse_size(positional[1]);
+        if (positional.size() > 2) cfg.leak         = (std::stoi(positional[2]) != 0);
+        if (positional.size() > 3) { print_usage(argv[0]); return 1; }
 
         if (cfg.chunk_bytes == 0) throw std::runtime_error("chunk must be > 0");
         if (cfg.target_bytes == 0) throw std::runtime_error("target must be > 0");
+        if (cfg.threads == 0) throw std::runtime_error("threads must be > 0");
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -76,35 +280,116 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::vector<char*> blocks;
+    std::unique_ptr<runtime::Executor> pool;
+    if (cfg.threads > 1) pool = std::make_unique<runtime::Executor>(cfg.threads - 1);
+    const std::size_t page = (cfg.mode == Mode::HugeTlb) ? mem::kHugePage : mem::kPage;
+
+    std::vector<Block> blocks;
     blocks.reserve(cfg.target_bytes / cfg.chunk_bytes + 1);
 
+    const CgroupMemory cgroup = CgroupMemory::detect();
+    if (cgroup.version) {
+        const long long lim = cgroup.limit();
+        std::printf("cgroup v%d: memory.current %.2f GB, ", cgroup.version, cgroup.current() / 1e9);
+        if (lim < 0) std::printf("no limit\n");
+        else std::printf("limit %.2f GB\n", lim / 1e9);
+        if (cfg.margin && lim < 0) std::printf("  no cgroup limit: --margin has nothing to guard\n");
+    } else if (cfg.margin) {
+        std::printf("no memory cgroup found: --margin ignored\n");
+    }
+
+    std::ofstream json;
+    if (!cfg.json_path.empty()) {
+        json.open(cfg.json_path);
+        if (!json) { std::cerr << "Error: cannot write " << cfg.json_path << "\n"; return 1; }
+        json << "{\"mode\": \"" << mode_name(cfg.mode) << "\", \"threads\": " << cfg.threads
+             << ", \"chunk_bytes\": " << cfg.chunk_bytes << ", \"target_bytes\": " << cfg.target_bytes
+             << ", \"cgroup_version\": " << cgroup.version << ", \"samples\": [";
+    }
+    const char* stop_reason = "target";
+
     std::size_t allocated = 0;
+    double commit_seconds = 0.0;
+    const Faults faults0 = page_faults();
+    const auto run_start = std::chrono::steady_clock::now();
 
     while (allocated < cfg.target_bytes) {
         std::size_t this_chunk = std::min(cfg.chunk_bytes, cfg.target_bytes - allocated);
 
-        char* p = nullptr;
-        try {
-            p = new char[this_chunk];
-        } catch (const std::bad_alloc&) {
-            std::cerr << "bad_alloc after ~" << (allocated / (1024.0 * 1024.0 * 1024.0)) << " GB\n";
+        // Safety stop: do not let the next chunk push the cgroup into its
+        // OOM killer; leave `margin` bytes of headroom.
+        if (cfg.margin) {
+            const long long lim = cgroup.limit(), cur = cgroup.current();
+            if (lim >= 0 && cur >= 0 &&
+                static_cast<unsigned long long>(cur) + this_chunk + cfg.margin > static_cast<unsigned long long>(lim)) {
+                std::printf("Stopping: cgroup at %.2f GB of %.2f GB, next chunk would cross the %.2f GB margin\n",
+                            cur / 1e9, lim / 1e9, cfg.margin / 1e9);
+                stop_reason = "margin";
+                break;
+            }
+        }
+
+        const Faults f0 = page_faults();
+        auto t0 = std::chrono::steady_clock::now();
+
+        Block b = allocate(cfg.mode, this_chunk);
+        if (!b.p) {
+            std::cerr << mode_name(cfg.mode) << " allocation failed after ~"
+                      << (allocated / (1024.0 * 1024.0 * 1024.0)) << " GB: "
+                      << (cfg.mode == Mode::New ? "bad_alloc" : std::strerror(errno)) << "\n";
+            if (cfg.mode == Mode::HugeTlb) std::cerr << "  (reserve pages first: sysctl vm.nr_hugepages=N)\n";
+            stop_reason = "alloc_failed";
             break;
         }
+        if (cfg.mode != Mode::Populate) mem::touch_pages_parallel(pool.get(), b.p, this_chunk, page);
 
-        touch_pages(p, this_chunk);
-        blocks.push_back(p);
+        const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        const Faults f1 = page_faults();
+        commit_seconds += s;
+        blocks.push_back(b);
         allocated += this_chunk;
 
-        std::cout << "Committed ~" << (allocated / (1024.0 * 1024.0 * 1024.0))
-                  << " GB (" << blocks.size() << " blocks)\n";
+        Sample smp;
+        smp.t_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+        smp.committed = allocated;
+        smp.chunk_ms = s * 1e3;
+        smp.gbps = this_chunk / s / 1e9;
+        smp.minor = f1.minor - f0.minor;
+        smp.major = f1.major - f0.major;
+        smp.status = read_proc_status();
+        smp.cg_current = cgroup.current();
+        smp.cg_limit = cgroup.limit();
+
+        std::printf("Committed ~%.2f GB (%zu blocks)  chunk %.1f ms  %.2f GB/s  faults minor %ld major %ld"
+                    "  RSS %.2f GB swap %.2f GB",
+                    allocated / (1024.0 * 1024.0 * 1024.0), blocks.size(), smp.chunk_ms, smp.gbps, smp.minor, smp.major,
+                    smp.status.rss_kb / (1024.0 * 1024.0), std::max(0L, smp.status.swap_kb) / (1024.0 * 1024.0));
+        if (smp.cg_current >= 0) std::printf("  cgroup %.2f GB", smp.cg_current / 1e9);
+        if (smp.cg_limit >= 0) std::printf(" / %.2f GB", smp.cg_limit / 1e9);
+        std::printf("\n");
+        if (json) write_json_sample(json, smp, blocks.size() == 1);
+    }
+
+    if (json) {
+        json << "\n  ], \"stop_reason\": \"" << stop_reason << "\", \"committed_bytes\": " << allocated << "}\n";
+        json.close();
     }
 
-    std::cout << "\nDone. leak=" << cfg.leak << ". Press Enter to exit...\n";
-    std::cin.get();
+    const Faults faults1 = page_faults();
+    const long minor = faults1.minor - faults0.minor;
+    std::printf("\nSummary: mode=%s threads=%u committed %.2f GB in %.3f s = %.2f GB/s, "
+                "minor faults %ld (%.1f per MB), major faults %ld\n",
+                mode_name(cfg.mode), cfg.threads, allocated / (1024.0 * 1024.0 * 1024.0), commit_seconds,
+                commit_seconds > 0 ? allocated / commit_seconds / 1e9 : 0.0, minor,
+                allocated ? minor / (allocated / (1024.0 * 1024.0)) : 0.0, faults1.major - faults0.major);
+
+    if (cfg.wait) {
+        std::cout << "\nDone. leak=" << cfg.leak << ". Press Enter to exit...\n";
+        std::cin.get();
+    }
 
     if (!cfg.leak) {
-        for (char* p : blocks) delete[] p;
+        for (Block& b : blocks) b.release();
         std::cout << "Freed all blocks.\n";
     } else {
         std::cout << "Intentionally leaked.\n";
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+
+#include "threadPool.hpp"
+
+// =======================================================
+// Page-level helpers shared by memoryOverflow.cpp and memoryHierarchy.cpp
+//   - parse_size("20GB")
+//   - map_thp(): 2MB-aligned anonymous mapping with MADV_HUGEPAGE
+//   - Region: RAII owner of such a mapping
+//   - touch_pages / touch_pages_parallel: first-touch commit, one write
+//     per page, optionally split across a runtime::Executor
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall memoryHierarchy.cpp -pthread
+// =======================================================
+
+namespace mem {
+
+constexpr std::size_t kPage = 4096;
+constexpr std::size_t kHugePage = 2ULL * 1024 * 1024;
+
+inline std::size_t round_up(std::size_t n, std::size_t align) { return (n + align - 1) / align * align; }
+
+// Parse strings like: "20GB", "512MB", "4096KB", "100B"
+inline std::size_t parse_size(std::string s) {
+    // remove spaces
+    s.erase(std::remove_if(s.begin(), s.end(), [](unsigned char c) { return std::isspace(c); }), s.end());
+    // uppercase
+    for (char& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    // split number + unit
+    std::size_t i = 0;
+    while (i < s.size() && (std::isdigit(static_cast<unsigned char>(s[i])) || s[i] == '.')) i++;
+    if (i == 0) throw std::runtime_error("Size must start with a number (e.g., 20GB)");
+
+    double value = std::stod(s.substr(0, i));
+    std::string unit = s.substr(i);
+
+    std::size_t mult = 1;
+    if (unit.empty() || unit == "B") mult = 1;
+    else if (unit == "KB") mult = 1024ULL;
+    else if (unit == "MB") mult = 1024ULL * 1024;
+    else if (unit == "GB") mult = 1024ULL * 1024 * 1024;
+    else if (unit == "TB") mult = 1024ULL * 1024 * 1024 * 1024;
+    else throw std::runtime_error("Unknown unit. Use B/KB/MB/GB/TB (e.g., 20GB)");
+
+    return static_cast<std::size_t>(value * static_cast<double>(mult));
+}
+
+// Over-maps by one huge page and trims, so the range is 2MB aligned and
+// khugepaged / the fault path can use huge pages for all of it. `bytes`
+// must already be a multiple of kHugePage. Not touched yet; nullptr if
+// the kernel refused.
+inline char* map_thp(std::size_t bytes) {
+    void* raw = mmap(nullptr, bytes + kHugePage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    auto addr = reinterpret_cast<std::uintptr_t>(raw);
+    auto aligned = round_up(addr, kHugePage);
+    if (aligned > addr) munmap(raw, aligned - addr);
+    munmap(reinterpret_cast<void*>(aligned + bytes), addr + kHugePage - aligned);
+    auto* p = reinterpret_cast<char*>(aligned);
+    madvise(p, bytes, MADV_HUGEPAGE);
+    return p;
+}
+
+// map_thp() with ownership; throws if the mapping fails.
+struct Region {
+    char* p = nullptr;
+    std::size_t bytes = 0;
+
+    explicit Region(std::size_t n) : bytes(round_up(std::max<std::size_t>(n, 1), kHugePage)) {
+        p = map_thp(bytes);
+        if (!p) throw std::runtime_error("mmap of " + std::to_string(bytes) + " bytes failed");
+    }
+    ~Region() { if (p) munmap(p, bytes); }
+    Region(const Region&) = delete;
+    Region& operator=(const Region&) = delete;
+};
+
+inline void touch_pages(char* p, std::size_t bytes, std::size_t page = kPage) {
+    for (std::size_t i = 0; i < bytes; i += page) p[i] = 1; // commit pages
+    if (bytes) p[bytes - 1] = 1;
+}
+
+// Page commit split across the pool: faults on different pages of one
+// mapping proceed in parallel (per-VMA locking permitting). The caller
+// helps, so `pool` has threads - 1 workers.
+inline void touch_pages_parallel(runtime::Executor* pool, char* p, std::size_t bytes, std::size_t page = kPage) {
+    if (!pool) return touch_pages(p, bytes, page);
+    constexpr std::size_t kSlice = 8ULL * 1024 * 1024;  // per task, multiple of both page sizes
+    const std::size_t slices = (bytes + kSlice - 1) / kSlice;
+    pool->parallel_for(0, slices, 1, [&](std::size_t s) {
+        const std::size_t off = s * kSlice;
+        touch_pages(p + off, std::min(kSlice, bytes - off), page);
+    });
+}
+
+} // namespace mem
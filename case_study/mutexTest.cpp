@@ -1,6 +1,29 @@
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "instrumentedMutex.hpp"
+#include "shardedStats.hpp"
+
+/* Usage
+./app                       # Case 1 and Case 2 (race vs mutex)
+./app bench                 # Case 3: 1..all cores, 1,000,000 ops per thread
+./app bench 16 5000000      # up to 16 threads, 5,000,000 ops per thread
+./app locks                 # Case 4: instrumented mutex overhead + per-site dump
+
+Build: g++ -std=c++20 -O2 mutexTest.cpp -pthread -o app
+*/
 
 // Case 1: Without mutex
 
@@ -44,9 +67,281 @@ void run_with_mutex() {
     std::cout << "[With mutex]    Counter: " << counter << std::endl;
 }
 
-int main() {
+// Case 2b: Same as Case 2, but with a sharded counter (no lock at all)
+
+void run_with_sharded_counter() {
+    sharded::Counter<> counter;
+
+    auto increment = [&counter]() {
+        for (int i = 0; i < 1000000; i++) {
+            counter++;   // thread-safe: each thread bumps its own cache line
+        }
+    };
+
+    std::thread t1(increment);
+    std::thread t2(increment);
+
+    t1.join();
+    t2.join();
+
+    std::cout << "[Sharded]       Counter: " << counter.load() << std::endl;
+}
+
+// Case 3: Lock/contention benchmark suite
+//   Every thread increments a shared counter `ops` times through one of the
+//   primitives below. ns/op is wall time per increment across all threads;
+//   efficiency is throughput(t) / (t * throughput(1)).
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Test-and-test-and-set: spin on a plain load so waiters share the cache
+// line read-only, and only try the exchange when the lock looks free.
+class TtasSpinlock {
+    std::atomic<bool> locked_{false};
+public:
+    void lock() {
+        for (int spins = 0;; ++spins) {
+            if (!locked_.exchange(true, std::memory_order_acquire)) return;
+            while (locked_.load(std::memory_order_relaxed)) {
+                if (++spins < 64) cpu_relax();
+                else std::this_thread::yield();  // oversubscribed: let the holder run
+            }
+        }
+    }
+    void unlock() { locked_.store(false, std::memory_order_release); }
+};
+
+// FIFO ticket lock: take a number, wait until it is served.
+class TicketLock {
+    std::atomic<std::uint32_t> next_{0};
+    std::atomic<std::uint32_t> serving_{0};
+public:
+    void lock() {
+        const std::uint32_t me = next_.fetch_add(1, std::memory_order_relaxed);
+        for (int spins = 0; serving_.load(std::memory_order_acquire) != me; ++spins) {
+            if (spins < 64) cpu_relax();
+            else std::this_thread::yield();
+        }
+    }
+    void unlock() { serving_.fetch_add(1, std::memory_order_release); }
+};
+
+constexpr std::size_t kCacheLine = 64;
+
+// One slot per thread, packed: neighbours share cache lines (false sharing).
+struct PackedSlot {
+    std::atomic<std::uint64_t> value{0};
+};
+
+// One slot per thread, each on its own cache line.
+struct alignas(kCacheLine) PaddedSlot {
+    std::atomic<std::uint64_t> value{0};
+};
+
+// Runs body(thread_index) on `threads` threads released together; returns seconds.
+template <typename Body>
+static double timed_run(unsigned threads, Body body) {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(t);
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template <typename Lock>
+static double bench_lock(unsigned threads, std::uint64_t ops, std::uint64_t& result) {
+    Lock lock;
+    std::uint64_t counter = 0;
+    double s = timed_run(threads, [&](unsigned) {
+        for (std::uint64_t i = 0; i < ops; ++i) {
+            lock.lock();
+            counter++;
+            lock.unlock();
+        }
+    });
+    result = counter;
+    return s;
+}
+
+static double bench_fetch_add(unsigned threads, std::uint64_t ops, std::uint64_t& result) {
+    std::atomic<std::uint64_t> counter{0};
+    double s = timed_run(threads, [&](unsigned) {
+        for (std::uint64_t i = 0; i < ops; ++i) counter.fetch_add(1, std::memory_order_relaxed);
+    });
+    result = counter.load();
+    return s;
+}
+
+// Each thread only writes its own slot; the total is summed after the run.
+template <typename Slot>
+static double bench_sharded(unsigned threads, std::uint64_t ops, std::uint64_t& result) {
+    std::unique_ptr<Slot[]> slots(new Slot[threads]);
+    double s = timed_run(threads, [&](unsigned t) {
+        auto& mine = slots[t].value;
+        for (std::uint64_t i = 0; i < ops; ++i) {
+            mine.store(mine.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    });
+    result = 0;
+    for (unsigned t = 0; t < threads; ++t) result += slots[t].value.load();
+    return s;
+}
+
+static double bench_sharded_counter(unsigned threads, std::uint64_t ops, std::uint64_t& result) {
+    sharded::Counter<> counter;
+    double s = timed_run(threads, [&](unsigned) {
+        for (std::uint64_t i = 0; i < ops; ++i) counter++;
+    });
+    result = counter.load();
+    return s;
+}
+
+static double bench_sharded_histogram(unsigned threads, std::uint64_t ops, std::uint64_t& result) {
+    sharded::Histogram<> hist;
+    double s = timed_run(threads, [&](unsigned t) {
+        for (std::uint64_t i = 0; i < ops; ++i) hist.record((i ^ t) & 0xFFFF);
+    });
+    result = hist.snapshot().count;
+    return s;
+}
+
+struct Primitive {
+    const char* name;
+    double (*run)(unsigned, std::uint64_t, std::uint64_t&);
+};
+
+void run_contention_suite(unsigned max_threads, std::uint64_t ops) {
+    const Primitive primitives[] = {
+        {"std::mutex", bench_lock<std::mutex>},
+        {"TTAS spinlock", bench_lock<TtasSpinlock>},
+        {"ticket lock", bench_lock<TicketLock>},
+        {"instrumented mutex", bench_lock<instrumented::Mutex>},
+        {"atomic fetch_add", bench_fetch_add},
+        {"sharded (packed)", bench_sharded<PackedSlot>},
+        {"sharded (padded)", bench_sharded<PaddedSlot>},
+        {"sharded::Counter", bench_sharded_counter},
+        {"sharded::Histogram", bench_sharded_histogram},
+    };
+
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+
+    std::cout << "[Contention suite] ops/thread=" << ops
+              << " hw_threads=" << std::thread::hardware_concurrency() << "\n";
+    std::cout << std::left << std::setw(20) << "primitive" << std::right << std::setw(8) << "threads"
+              << std::setw(12) << "ns/op" << std::setw(12) << "Mops/s" << std::setw(12) << "efficiency" << "\n";
+
+    for (const auto& p : primitives) {
+        double base = 0.0;  // single-thread throughput
+        for (unsigned t : counts) {
+            std::uint64_t result = 0;
+            double s = p.run(t, ops, result);
+            const double total = static_cast<double>(ops) * t;
+            const double mops = total / s / 1e6;
+            if (t == counts.front()) base = mops / t;
+
+            std::cout << std::left << std::setw(20) << p.name << std::right << std::setw(8) << t
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(12) << s * 1e9 / total
+                      << std::setw(12) << mops
+                      << std::setw(11) << 100.0 * mops / (t * base) << "%"
+                      << (result == ops * t ? "" : "  WRONG COUNT") << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+}
+
+// Case 4: Instrumented mutex
+//   Uncontended overhead vs std::mutex (budget: 20 ns per lock/unlock), then
+//   two threads sharing one mutex from two call sites, dumped per site.
+
+template <typename Lock>
+static double uncontended_ns(std::uint64_t ops) {
+    Lock lock;
+    volatile std::uint64_t counter = 0;
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < ops; ++i) {
+            lock.lock();
+            counter = counter + 1;
+            lock.unlock();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        best = std::min(best, ns / static_cast<double>(ops));
+    }
+    return best;
+}
+
+bool run_instrumented_locks(std::uint64_t ops) {
+    const double plain = uncontended_ns<std::mutex>(ops);
+    const double inst = uncontended_ns<instrumented::Mutex>(ops);
+    const double added = inst - plain;
+    std::cout << std::fixed << std::setprecision(2)
+              << "[Instrumented] uncontended lock+unlock: std::mutex " << plain << " ns, instrumented "
+              << inst << " ns, added " << added << " ns (budget 20 ns) "
+              << (added < 20.0 ? "PASS" : "FAIL") << "\n\n";
+    std::cout.unsetf(std::ios::fixed);
+
+    instrumented::Mutex book("orders.book");
+    std::uint64_t orders = 0;
+    auto writer = [&] {
+        for (int i = 0; i < 200000; ++i) {
+            instrumented::Guard g(book, XLAB_LOCK_SITE("orders.insert"));
+            orders++;
+        }
+    };
+    auto reader = [&] {
+        std::uint64_t seen = 0;
+        for (int i = 0; i < 20000; ++i) {
+            instrumented::Guard g(book, XLAB_LOCK_SITE("orders.scan"));
+            for (int k = 0; k < 100; ++k) seen += orders;  // long hold
+        }
+        return seen;
+    };
+    std::thread t1(writer);
+    std::thread t2(reader);
+    t1.join();
+    t2.join();
+
+    instrumented::dump(std::cout);
+    return added < 20.0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        unsigned max_threads = (argc > 2) ? static_cast<unsigned>(std::stoul(argv[2])) : hw;
+        std::uint64_t ops = (argc > 3) ? std::stoull(argv[3]) : 1000000;
+        run_contention_suite(std::max(1u, max_threads), ops);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "locks") {
+        std::uint64_t ops = (argc > 2) ? std::stoull(argv[2]) : 5000000;
+        return run_instrumented_locks(ops) ? 0 : 1;
+    }
+
     run_without_mutex();
     run_with_mutex();
+    run_with_sharded_counter();
     return 0;
 }
 
@@ -70,11 +365,17 @@ leading to race conditions and undefined behavior. [1]
 
 2) Experiments without mutex in LeetCode's Playground show that correct results are common
 at low iteration counts, but become increasingly rare as the count grows,
-suggesting nondeterministic behavior due to concurrent execution. */
+suggesting nondeterministic behavior due to concurrent execution.
+
+3) Correct is not the same as scalable. Every primitive in Case 3 gives the right
+count, but a single shared counter (mutex, spinlock, ticket lock or even one atomic)
+bounces its cache line between cores, so ns/op grows with threads.
+Per-thread slots only scale when each slot has its own cache line (false sharing). [2] */
 
 
 
 
 /* < Reference >
-[1] Race condition: the program's outcome depends on the timing or order of those accesses.  */
+[1] Race condition: the program's outcome depends on the timing or order of those accesses.
+[2] False sharing: independent variables on the same cache line still invalidate each other.  */
 
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "threadPool.hpp"
+
+// =======================================================
+// Parallel for_each / reduce / sort on runtime::Executor
+//   Parallel versions of lambda.cpp CASE 10 (for_each) and CASE 11 (sort
+//   with a lambda comparator):
+//
+//     parallel::for_each(parallel::par, v.begin(), v.end(), [](int& x) { ... });
+//     auto sum = parallel::reduce(parallel::par, v.begin(), v.end(), 0LL);
+//     parallel::sort(parallel::par, v.begin(), v.end(), [](int a, int b) { return a > b; });
+//     parallel::radix_sort(parallel::par, v.begin(), v.end());   // integer keys
+//
+//   Policies mirror std::execution::seq / par. (libstdc++'s own parallel
+//   algorithms need TBB; these run on our Executor instead.) `par` uses a
+//   process-wide executor; parallel::on(ex) picks a specific one.
+//
+//   sort      chunked std::sort, then merge passes that are themselves
+//             split by merge path, so the last merge still uses every
+//             worker. Not stable. Needs random-access iterators and a
+//             default-constructible value type (one n-sized buffer).
+//   radix_sort LSD, 8 bits per pass, per-chunk histograms + scatter.
+//             Passes where every key has the same digit are skipped.
+//
+//   CASE 10 sums through a captured reference; from several threads that
+//   is a data race, so use reduce (per-chunk partials) instead.
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall parallelSortBench.cpp -pthread
+// =======================================================
+
+namespace parallel {
+
+struct sequenced_policy {};
+
+struct parallel_policy {
+    runtime::Executor* executor = nullptr;   // nullptr: default_executor()
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+inline parallel_policy on(runtime::Executor& ex) { return parallel_policy{&ex}; }
+
+inline runtime::Executor& default_executor() {
+    static runtime::Executor ex;
+    return ex;
+}
+
+namespace detail {
+
+inline runtime::Executor& executor_of(const parallel_policy& p) {
+    return p.executor ? *p.executor : default_executor();
+}
+
+// Below this many elements splitting costs more than it saves.
+constexpr std::size_t kSerialCutoff = 1 << 14;
+
+// About four chunks per worker so a slow chunk does not stall the rest.
+inline std::size_t chunk_count(const runtime::Executor& ex, std::size_t n, std::size_t min_chunk) {
+    const std::size_t by_size = std::max<std::size_t>(n / min_chunk, 1);
+    return std::min<std::size_t>(std::size_t(ex.size()) * 4, by_size);
+}
+
+// Number of elements taken from a in the first k outputs of a stable
+// merge of sorted a[0, m) and b[0, n).
+template <class It, class Compare>
+std::size_t co_rank(std::size_t k, It a, std::size_t m, It b, std::size_t n, Compare& comp) {
+    std::size_t lo = k > n ? k - n : 0;
+    std::size_t hi = std::min(k, m);
+    while (lo < hi) {
+        const std::size_t i = lo + (hi - lo) / 2;
+        const std::size_t j = k - i;
+        if (!comp(b[j - 1], a[i])) lo = i + 1;   // a[i] goes before b[j-1]
+        else hi = i;
+    }
+    return lo;
+}
+
+// std::merge over move iterators would hand comp rvalues, which rejects
+// comparators std::sort accepts (e.g. [](auto& a, auto& b)). This compares
+// lvalues and moves each element into out; ties take from a (stable).
+template <class InA, class InB, class Out, class Compare>
+Out move_merge(InA a, InA a_end, InB b, InB b_end, Out out, Compare& comp) {
+    for (; a != a_end && b != b_end; ++out) {
+        if (comp(*b, *a)) {
+            *out = std::move(*b);
+            ++b;
+        } else {
+            *out = std::move(*a);
+            ++a;
+        }
+    }
+    out = std::move(a, a_end, out);
+    return std::move(b, b_end, out);
+}
+
+} // namespace detail
+
+// =======================================================
+// for_each / reduce
+// =======================================================
+template <class It, class F>
+void for_each(sequenced_policy, It first, It last, F f) {
+    std::for_each(first, last, f);
+}
+
+template <class It, class F>
+void for_each(const parallel_policy& policy, It first, It last, F f) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    auto& ex = detail::executor_of(policy);
+    const std::size_t chunks = detail::chunk_count(ex, n, detail::kSerialCutoff);
+    ex.parallel_for(0, chunks, 1, [&](std::size_t c) {
+        std::for_each(first + n * c / chunks, first + n * (c + 1) / chunks, f);
+    });
+}
+
+template <class It, class T, class Op = std::plus<>>
+T reduce(sequenced_policy, It first, It last, T init, Op op = {}) {
+    return std::accumulate(first, last, std::move(init), op);
+}
+
+// op must be associative; partials are combined in chunk order.
+template <class It, class T, class Op = std::plus<>>
+T reduce(const parallel_policy& policy, It first, It last, T init, Op op = {}) {
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    auto& ex = detail::executor_of(policy);
+    const std::size_t chunks = detail::chunk_count(ex, n, detail::kSerialCutoff);
+    if (chunks <= 1) return std::accumulate(first, last, std::move(init), op);
+
+    struct alignas(runtime::kCacheLine) Partial {
+        T value;
+    };
+    std::vector<Partial> partial(chunks);
+    ex.parallel_for(0, chunks, 1, [&](std::size_t c) {
+        It lo = first + n * c / chunks;
+        It hi = first + n * (c + 1) / chunks;
+        T acc = *lo;
+        for (++lo; lo != hi; ++lo) acc = op(std::move(acc), *lo);
+        partial[c].value = std::move(acc);
+    });
+    for (auto& p : partial) init = op(std::move(init), std::move(p.value));
+    return init;
+}
+
+// =======================================================
+// sort: chunk sort + parallel merge passes
+// =======================================================
+template <class It, class Compare = std::less<>>
+void sort(sequenced_policy, It first, It last, Compare comp = {}) {
+    std::sort(first, last, comp);
+}
+
+template <class It, class Compare = std::less<>>
+void sort(const parallel_policy& policy, It first, It last, Compare comp = {}) {
+    using T = typename std::iterator_traits<It>::value_type;
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    auto& ex = detail::executor_of(policy);
+    const std::size_t chunks = detail::chunk_count(ex, n, detail::kSerialCutoff);
+    if (chunks <= 1) return std::sort(first, last, comp);
+
+    // 1) Sort equal chunks independently.
+    const std::size_t width = (n + chunks - 1) / chunks;
+    ex.parallel_for(0, chunks, 1, [&](std::size_t c) {
+        const std::size_t lo = std::min(n, c * width), hi = std::min(n, lo + width);
+        std::sort(first + lo, first + hi, comp);
+    });
+
+    // 2) Merge runs of `run` into runs of 2*run, ping-ponging between the
+    //    input and one buffer. Each pair's output is cut into pieces of
+    //    about `piece` elements, located in the inputs by co_rank.
+    auto buffer = std::make_unique_for_overwrite<T[]>(n);
+    const std::size_t piece = std::max<std::size_t>(n / (std::size_t(ex.size()) * 4), detail::kSerialCutoff);
+
+    struct Piece {
+        std::size_t lo, mid, hi;   // the pair: [lo, mid) and [mid, hi)
+        std::size_t k0, k1;        // output range within the pair
+        std::size_t i0, i1;        // elements taken from [lo, mid) before k0 / k1
+    };
+    std::vector<Piece> pieces;
+    bool in_buffer = false;
+
+    for (std::size_t run = width; run < n; run *= 2) {
+        pieces.clear();
+        for (std::size_t lo = 0; lo < n; lo += 2 * run) {
+            const std::size_t mid = std::min(n, lo + run), hi = std::min(n, lo + 2 * run);
+            for (std::size_t k = 0; k < hi - lo; k += piece)
+                pieces.push_back({lo, mid, hi, k, std::min(hi - lo, k + piece), 0, 0});
+        }
+        // All split points are found before any piece moves elements out:
+        // co_rank of one piece reads the whole pair.
+        auto pass = [&](auto src, auto dst) {
+            ex.parallel_for(0, pieces.size(), 1, [&](std::size_t p) {
+                Piece& pc = pieces[p];
+                const std::size_t m = pc.mid - pc.lo, bn = pc.hi - pc.mid;
+                pc.i0 = detail::co_rank(pc.k0, src + pc.lo, m, src + pc.mid, bn, comp);
+                pc.i1 = detail::co_rank(pc.k1, src + pc.lo, m, src + pc.mid, bn, comp);
+            });
+            ex.parallel_for(0, pieces.size(), 1, [&](std::size_t p) {
+                const Piece& pc = pieces[p];
+                auto a = src + pc.lo, b = src + pc.mid;
+                detail::move_merge(a + pc.i0, a + pc.i1, b + (pc.k0 - pc.i0), b + (pc.k1 - pc.i1),
+                                   dst + pc.lo + pc.k0, comp);
+            });
+        };
+        if (in_buffer) pass(buffer.get(), first);
+        else pass(first, buffer.get());
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        T* src = buffer.get();
+        ex.parallel_for(0, chunks, 1, [&](std::size_t c) {
+            const std::size_t lo = n * c / chunks, hi = n * (c + 1) / chunks;
+            std::move(src + lo, src + hi, first + lo);
+        });
+    }
+}
+
+// =======================================================
+// radix_sort: LSD, integer keys, ascending
+// =======================================================
+namespace detail {
+
+template <class T>
+auto radix_key(T v) {
+    using U = std::make_unsigned_t<T>;
+    U u = static_cast<U>(v);
+    if constexpr (std::is_signed_v<T>) u ^= U(1) << (std::numeric_limits<U>::digits - 1);   // order negatives first
+    return u;
+}
+
+} // namespace detail
+
+template <class It, class Policy>
+    requires(std::is_same_v<Policy, sequenced_policy> || std::is_same_v<Policy, parallel_policy>)
+void radix_sort(const Policy& policy, It first, It last) {
+    using T = typename std::iterator_traits<It>::value_type;
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "radix_sort needs integer keys");
+    static_assert(std::contiguous_iterator<It>, "radix_sort needs contiguous storage");
+    constexpr std::size_t kBuckets = 256;
+    constexpr int kPasses = sizeof(T);
+
+    const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < 2) return;
+
+    runtime::Executor* ex = nullptr;
+    std::size_t chunks = 1;
+    if constexpr (std::is_same_v<Policy, parallel_policy>) {
+        ex = &detail::executor_of(policy);
+        chunks = detail::chunk_count(*ex, n, detail::kSerialCutoff);
+    }
+    auto run_chunks = [&](auto&& body) {
+        if (chunks == 1) body(std::size_t(0));
+        else ex->parallel_for(0, chunks, 1, body);
+    };
+
+    auto buffer = std::make_unique_for_overwrite<T[]>(n);
+    T* src = std::to_address(first);
+    T* dst = buffer.get();
+    // counts[c * kBuckets + d]: keys of chunk c with digit d in this pass.
+    std::vector<std::size_t> counts(chunks * kBuckets);
+
+    for (int pass = 0; pass < kPasses; ++pass) {
+        const int shift = pass * 8;
+        std::fill(counts.begin(), counts.end(), 0);
+        run_chunks([&](std::size_t c) {
+            std::size_t* cnt = &counts[c * kBuckets];
+            for (std::size_t i = n * c / chunks, e = n * (c + 1) / chunks; i < e; ++i)
+                ++cnt[(detail::radix_key(src[i]) >> shift) & 0xFF];
+        });
+
+        // Turn counts into write offsets, digit-major then chunk order
+        // (that order keeps the sort stable between passes).
+        std::size_t offset = 0, used = 0;
+        for (std::size_t d = 0; d < kBuckets; ++d) {
+            std::size_t total = 0;
+            for (std::size_t c = 0; c < chunks; ++c) {
+                const std::size_t k = counts[c * kBuckets + d];
+                counts[c * kBuckets + d] = offset;
+                offset += k;
+                total += k;
+            }
+            used += total != 0;
+        }
+        if (used == 1) continue;   // every key has this digit; nothing moves
+
+        run_chunks([&](std::size_t c) {
+            std::size_t* pos = &counts[c * kBuckets];
+            for (std::size_t i = n * c / chunks, e = n * (c + 1) / chunks; i < e; ++i)
+                dst[pos[(detail::radix_key(src[i]) >> shift) & 0xFF]++] = src[i];
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != std::to_address(first)) std::copy(src, src + n, std::to_address(first));
+}
+
+} // namespace parallel
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parallelAlgorithms.hpp"
+#include "threadPool.hpp"
+
+/* Usage
+./app                 # 1M and 10M ints, 1..hardware_concurrency() threads
+./app 100000000 8     # up to 100M ints (about 1.2 GB peak), 1..8 threads
+
+Build: g++ -std=c++20 -O2 parallelSortBench.cpp -pthread -o app
+*/
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+static double time_ms(F f) {
+    auto t0 = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+static std::vector<unsigned> thread_counts(unsigned max_threads) {
+    std::vector<unsigned> v;
+    for (unsigned t = 1; t < max_threads; t *= 2) v.push_back(t);
+    v.push_back(max_threads);
+    return v;
+}
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        std::exit(1);
+    }
+}
+
+static void bench_size(std::size_t n, unsigned max_threads) {
+    std::vector<std::int32_t> input(n);
+    std::mt19937_64 rng(n);
+    for (auto& x : input) x = static_cast<std::int32_t>(rng());
+
+    // Single-threaded baselines, shared by every row.
+    auto v = input;
+    const double std_sort = time_ms([&] { std::sort(v.begin(), v.end()); });
+    const auto expected = v;
+    v = input;
+    // Non-const lvalue-reference parameters: std::sort accepts them, so must we.
+    const double std_desc = time_ms([&] { std::sort(v.begin(), v.end(), [](auto& a, auto& b) { return a > b; }); });
+    long long expected_sum = 0;
+    const double std_sum = time_ms([&] { expected_sum = std::accumulate(input.begin(), input.end(), 0LL); });
+
+    std::printf("\n[n = %zu] std::sort %.1f ms, std::sort(desc lambda) %.1f ms, std::accumulate %.2f ms\n", n, std_sort,
+                std_desc, std_sum);
+    std::printf("  %7s %12s %8s %14s %12s %8s %11s %8s\n", "threads", "sort ms", "x std", "sort desc ms", "radix ms",
+                "x std", "reduce ms", "x std");
+
+    for (unsigned t : thread_counts(max_threads)) {
+        runtime::Executor ex(t);
+        const auto policy = parallel::on(ex);
+
+        v = input;
+        const double sort_ms = time_ms([&] { parallel::sort(policy, v.begin(), v.end()); });
+        check(v == expected, "parallel::sort");
+
+        v = input;
+        const double desc_ms = time_ms([&] { parallel::sort(policy, v.begin(), v.end(), [](auto& a, auto& b) { return a > b; }); });
+        check(std::equal(v.begin(), v.end(), expected.rbegin()), "parallel::sort desc");
+
+        v = input;
+        const double radix_ms = time_ms([&] { parallel::radix_sort(policy, v.begin(), v.end()); });
+        check(v == expected, "parallel::radix_sort");
+
+        long long sum = 0;
+        const double reduce_ms = time_ms([&] { sum = parallel::reduce(policy, input.begin(), input.end(), 0LL); });
+        check(sum == expected_sum, "parallel::reduce");
+
+        std::printf("  %7u %12.1f %8.2f %14.1f %12.1f %8.2f %11.2f %8.2f\n", t, sort_ms, std_sort / sort_ms, desc_ms,
+                    radix_ms, std_sort / radix_ms, reduce_ms, std_sum / reduce_ms);
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t max_n = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    std::printf("sizes up to %zu, threads 1..%u (hardware_concurrency %u)\n", max_n, threads,
+                std::thread::hardware_concurrency());
+    for (std::size_t n = 1'000'000; n <= max_n; n *= 10) bench_size(n, threads);
+    return 0;
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// =======================================================
+// PersonTable: columnar (struct-of-arrays) Person store
+//   classDesign.cpp's Person keeps a std::string and an int side by side.
+//   In a std::vector<Person>, a scan over ages drags 40-byte records
+//   through the cache, and every name past the 15-char SSO buffer is its
+//   own heap allocation.
+//
+//   Here each field is its own column:
+//     ages      int32, contiguous
+//     name ids  uint32 per row, into a NameDictionary
+//   and every distinct name is stored once, back to back in one arena
+//   (chars + offsets), with an open-addressing index for interning.
+//
+//   Predicates scan one column. Name equality becomes one dictionary
+//   lookup plus an integer compare per row. Counting loops are compiled
+//   per CPU level (AVX-512 / AVX2 / baseline) like exprVector.hpp.
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall personTableBench.cpp
+// =======================================================
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define XLAB_COLUMNAR_SIMD __attribute__((target_clones("avx512f", "avx2", "default"), optimize("tree-vectorize")))
+#else
+#define XLAB_COLUMNAR_SIMD
+#endif
+
+namespace columnar {
+
+using NameId = std::uint32_t;
+using Row = std::uint32_t;
+
+// =======================================================
+// NameDictionary: intern table over a single character arena
+// =======================================================
+class NameDictionary {
+public:
+    NameDictionary() { offsets_.push_back(0); }
+
+    std::size_t size() const noexcept { return offsets_.size() - 1; }
+
+    std::string_view name(NameId id) const noexcept {
+        return {chars_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]};
+    }
+
+    std::optional<NameId> find(std::string_view s) const noexcept {
+        if (slots_.empty()) return std::nullopt;
+        for (std::size_t i = hash(s) & mask(); ; i = (i + 1) & mask()) {
+            const NameId id = slots_[i];
+            if (id == kEmpty) return std::nullopt;
+            if (name(id) == s) return id;
+        }
+    }
+
+    // Returns the existing id, or stores the name and hands out the next one.
+    NameId intern(std::string_view s) {
+        if ((size() + 1) * 4 > slots_.size() * 3) rehash(std::max<std::size_t>(slots_.size() * 2, 1024));
+        std::size_t i = hash(s) & mask();
+        for (; slots_[i] != kEmpty; i = (i + 1) & mask())
+            if (name(slots_[i]) == s) return slots_[i];
+        if (chars_.size() + s.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("NameDictionary: arena over 4 GiB");
+        const auto id = static_cast<NameId>(size());
+        const std::size_t old_chars = chars_.size();
+        chars_.insert(chars_.end(), s.begin(), s.end());
+        try {
+            offsets_.push_back(static_cast<std::uint32_t>(chars_.size()));
+        } catch (...) {
+            chars_.resize(old_chars);   // name(id) must keep ending at offsets_.back()
+            throw;
+        }
+        slots_[i] = id;
+        return id;
+    }
+
+    void reserve(std::size_t names, std::size_t chars) {
+        offsets_.reserve(names + 1);
+        chars_.reserve(chars);
+    }
+
+    std::size_t footprint_bytes() const noexcept {
+        return chars_.capacity() + offsets_.capacity() * sizeof(std::uint32_t) + slots_.capacity() * sizeof(NameId);
+    }
+
+private:
+    static constexpr NameId kEmpty = std::numeric_limits<NameId>::max();
+
+    // FNV-1a; names are short, so this beats anything fancier.
+    static std::size_t hash(std::string_view s) noexcept {
+        std::uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : s) h = (h ^ c) * 1099511628211ull;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    std::size_t mask() const noexcept { return slots_.size() - 1; }
+
+    // Builds the new index aside, so a bad_alloc leaves the old one intact.
+    void rehash(std::size_t capacity) {
+        std::vector<NameId> slots(capacity, kEmpty);
+        const std::size_t m = capacity - 1;
+        for (NameId id = 0; id < size(); ++id) {
+            std::size_t i = hash(name(id)) & m;
+            while (slots[i] != kEmpty) i = (i + 1) & m;
+            slots[i] = id;
+        }
+        slots_.swap(slots);
+    }
+
+    std::vector<char> chars_;
+    std::vector<std::uint32_t> offsets_;   // name i is chars_[offsets_[i], offsets_[i + 1])
+    std::vector<NameId> slots_;            // power-of-two open-addressing index
+};
+
+namespace detail {
+
+template <class T>
+XLAB_COLUMNAR_SIMD std::size_t count_between(const T* v, std::size_t n, T lo, T hi) {
+    // lo <= x < hi as one unsigned compare, so the loop has no branches.
+    using U = std::make_unsigned_t<T>;
+    const U width = static_cast<U>(static_cast<U>(hi) - static_cast<U>(lo));
+    std::size_t c = 0;
+    for (std::size_t i = 0; i < n; ++i) c += static_cast<U>(static_cast<U>(v[i]) - static_cast<U>(lo)) < width;
+    return c;
+}
+
+template <class T>
+XLAB_COLUMNAR_SIMD std::size_t count_equal(const T* v, std::size_t n, T x) {
+    std::size_t c = 0;
+    for (std::size_t i = 0; i < n; ++i) c += v[i] == x;
+    return c;
+}
+
+XLAB_COLUMNAR_SIMD inline std::size_t count_name_and_age(const NameId* ids, const std::int32_t* ages, std::size_t n,
+                                                         NameId id, std::int32_t lo, std::int32_t hi) {
+    const auto width = static_cast<std::uint32_t>(hi) - static_cast<std::uint32_t>(lo);
+    std::size_t c = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        c += (ids[i] == id) & (static_cast<std::uint32_t>(ages[i]) - static_cast<std::uint32_t>(lo) < width);
+    return c;
+}
+
+} // namespace detail
+
+// =======================================================
+// PersonTable
+// =======================================================
+class PersonTable {
+public:
+    std::size_t size() const noexcept { return ages_.size(); }
+
+    void reserve(std::size_t rows) {
+        ages_.reserve(rows);
+        name_ids_.reserve(rows);
+    }
+
+    // Everything that can throw (growing the columns, interning) happens
+    // before either column changes, so the columns never differ in length.
+    Row append(std::string_view name, int age) {
+        check_rows(1);
+        grow_for(1);
+        const NameId id = names_.intern(name);
+        ages_.push_back(age);        // no reallocation: capacity reserved above
+        name_ids_.push_back(id);
+        return static_cast<Row>(ages_.size() - 1);
+    }
+
+    // Bulk append: grow both columns (geometrically, so many small batches
+    // stay linear), intern everything into a side vector, then column by
+    // column.
+    void append(std::span<const std::string_view> names, std::span<const int> ages) {
+        if (names.size() != ages.size()) throw std::invalid_argument("PersonTable::append: column lengths differ");
+        check_rows(names.size());
+        grow_for(names.size());
+        std::vector<NameId> ids;
+        ids.reserve(names.size());
+        for (std::string_view n : names) ids.push_back(names_.intern(n));
+        ages_.insert(ages_.end(), ages.begin(), ages.end());
+        name_ids_.insert(name_ids_.end(), ids.begin(), ids.end());
+    }
+
+    std::string_view name(Row r) const { return names_.name(name_ids_.at(r)); }
+    int age(Row r) const { return ages_.at(r); }
+
+    std::span<const std::int32_t> ages() const noexcept { return ages_; }
+    std::span<const NameId> name_ids() const noexcept { return name_ids_; }
+    const NameDictionary& names() const noexcept { return names_; }
+
+    // ---- predicates: age in [lo, hi) ----
+    std::size_t count_age_between(int lo, int hi) const {
+        if (lo >= hi) return 0;
+        return detail::count_between<std::int32_t>(ages_.data(), ages_.size(), lo, hi);
+    }
+
+    std::vector<Row> select_age_between(int lo, int hi) const {
+        if (lo >= hi) return {};
+        const auto width = static_cast<std::uint32_t>(hi) - static_cast<std::uint32_t>(lo);
+        return select(count_age_between(lo, hi), [&](std::size_t i) {
+            return static_cast<std::uint32_t>(ages_[i]) - static_cast<std::uint32_t>(lo) < width;
+        });
+    }
+
+    // ---- predicates: name equality via the dictionary id ----
+    std::size_t count_name(std::string_view name) const {
+        const auto id = names_.find(name);
+        return id ? detail::count_equal(name_ids_.data(), name_ids_.size(), *id) : 0;
+    }
+
+    std::vector<Row> select_name(std::string_view name) const {
+        const auto id = names_.find(name);
+        if (!id) return {};
+        return select(detail::count_equal(name_ids_.data(), name_ids_.size(), *id),
+                      [&](std::size_t i) { return name_ids_[i] == *id; });
+    }
+
+    std::size_t count_name_and_age(std::string_view name, int lo, int hi) const {
+        const auto id = names_.find(name);
+        if (!id || lo >= hi) return 0;
+        return detail::count_name_and_age(name_ids_.data(), ages_.data(), size(), *id, lo, hi);
+    }
+
+    // Bytes held by the columns and the dictionary (capacity, not size).
+    std::size_t footprint_bytes() const noexcept {
+        return ages_.capacity() * sizeof(std::int32_t) + name_ids_.capacity() * sizeof(NameId) + names_.footprint_bytes();
+    }
+
+private:
+    void check_rows(std::size_t more) const {
+        if (size() + more > std::numeric_limits<Row>::max()) throw std::length_error("PersonTable: too many rows");
+    }
+
+    // Geometric growth by hand: reserve(size() + 1) on every append would
+    // reallocate every time.
+    void grow_for(std::size_t more) {
+        const std::size_t need = size() + more;
+        if (need <= std::min(ages_.capacity(), name_ids_.capacity())) return;
+        reserve(std::max(need, 2 * size()));
+    }
+
+    // Branch-free compaction: always write the row, advance on a match.
+    // The vectorized count comes first, so the output is sized exactly
+    // (plus the one slot a trailing non-match writes into).
+    template <class Pred>
+    std::vector<Row> select(std::size_t matches, Pred pred) const {
+        std::vector<Row> rows(matches + 1);
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < size(); ++i) {
+            rows[k] = static_cast<Row>(i);
+            k += pred(i);
+        }
+        rows.resize(k);
+        return rows;
+    }
+
+    std::vector<std::int32_t> ages_;
+    std::vector<NameId> name_ids_;
+    NameDictionary names_;
+};
+
+} // namespace columnar
@@ -0,0 +1,204 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "personTable.hpp"
+
+/* Usage
+./app              # 5M people, 20k distinct names
+./app 20000000     # more rows
+
+Build: g++ -std=c++20 -O2 personTableBench.cpp -o app
+*/
+
+// =======================================================
+// Heap accounting (this program only): live bytes requested via new
+// =======================================================
+static std::atomic<std::int64_t> g_heap_bytes{0};
+static std::atomic<std::int64_t> g_heap_allocs{0};
+
+void* operator new(std::size_t n) {
+    // Keep the size in a 16-byte header so operator delete can subtract it.
+    auto* p = static_cast<char*>(std::malloc(n + 16));
+    if (!p) throw std::bad_alloc();
+    *reinterpret_cast<std::size_t*>(p) = n;
+    g_heap_bytes.fetch_add(static_cast<std::int64_t>(n), std::memory_order_relaxed);
+    g_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+    return p + 16;
+}
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    auto* base = static_cast<char*>(p) - 16;
+    g_heap_bytes.fetch_sub(static_cast<std::int64_t>(*reinterpret_cast<std::size_t*>(base)), std::memory_order_relaxed);
+    std::free(base);
+}
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+
+// Person from classDesign.cpp, unchanged.
+class Person {
+public:
+    Person(std::string name, int age)
+        : name_(std::move(name)), age_(age) {}
+
+    const std::string& getName() const noexcept {
+        return name_;
+    }
+
+    int getAge() const noexcept {
+        return age_;
+    }
+
+private:
+    std::string name_;
+    int age_;
+};
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+static double best_ms(F f, int reps = 5) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    return best;
+}
+
+template <class T>
+static void do_not_optimize(const T& v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+static void check(std::size_t a, std::size_t b, const char* what) {
+    if (a != b) {
+        std::fprintf(stderr, "MISMATCH %s: %zu vs %zu\n", what, a, b);
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t rows = argc > 1 ? std::stoull(argv[1]) : 5'000'000;
+    constexpr std::size_t kDistinct = 20'000;
+
+    // Names 4..27 chars: roughly half fit std::string's 15-char SSO buffer.
+    std::mt19937_64 rng(7);
+    std::vector<std::string> pool;
+    pool.push_back("Alice");
+    while (pool.size() < kDistinct) {
+        std::string s(4 + rng() % 24, 'a');
+        for (char& c : s) c = static_cast<char>('a' + rng() % 26);
+        s[0] = static_cast<char>(s[0] - 'a' + 'A');
+        pool.push_back(std::move(s));
+    }
+    std::vector<std::string_view> names(rows);
+    std::vector<int> ages(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        names[i] = pool[(rng() % 8 == 0) ? 0 : rng() % kDistinct];   // "Alice" is common
+        ages[i] = static_cast<int>(rng() % 100);
+    }
+
+    std::printf("%zu people, %zu distinct names, sizeof(Person) = %zu\n", rows, kDistinct, sizeof(Person));
+
+    // ---------------------------------------------------- build + footprint
+    std::printf("\n[build + footprint]\n  %-34s %10s %12s %12s\n", "layout", "build ms", "heap MB", "allocations");
+
+    std::vector<Person> aos;
+    {
+        const auto b0 = g_heap_bytes.load(), a0 = g_heap_allocs.load();
+        auto t0 = Clock::now();
+        aos.reserve(rows);
+        for (std::size_t i = 0; i < rows; ++i) aos.emplace_back(std::string(names[i]), ages[i]);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        std::printf("  %-34s %10.1f %12.1f %12lld\n", "std::vector<Person> (AoS)", ms,
+                    double(g_heap_bytes.load() - b0) / 1e6, static_cast<long long>(g_heap_allocs.load() - a0));
+    }
+
+    columnar::PersonTable table;
+    {
+        const auto b0 = g_heap_bytes.load(), a0 = g_heap_allocs.load();
+        auto t0 = Clock::now();
+        table.append(names, ages);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        std::printf("  %-34s %10.1f %12.1f %12lld\n", "PersonTable (bulk append)", ms,
+                    double(g_heap_bytes.load() - b0) / 1e6, static_cast<long long>(g_heap_allocs.load() - a0));
+        std::printf("  PersonTable::footprint_bytes()     %23.1f MB\n", double(table.footprint_bytes()) / 1e6);
+    }
+    {
+        columnar::PersonTable one_by_one;
+        auto t0 = Clock::now();
+        for (std::size_t i = 0; i < rows; ++i) one_by_one.append(names[i], ages[i]);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        std::printf("  %-34s %10.1f\n", "PersonTable (append per row)", ms);
+    }
+
+    // ---------------------------------------------------- scans
+    std::printf("\n[scan] best of 5\n  %-34s %10s %10s %10s\n", "query", "AoS ms", "SoA ms", "speedup");
+    auto row = [](const char* q, double aos_ms, double soa_ms) {
+        std::printf("  %-34s %10.2f %10.2f %9.1fx\n", q, aos_ms, soa_ms, aos_ms / soa_ms);
+    };
+
+    {
+        std::size_t a = 0, s = 0;
+        const double aos_ms = best_ms([&] {
+            a = 0;
+            for (const Person& p : aos) a += p.getAge() >= 30 && p.getAge() < 40;
+            do_not_optimize(a);
+        });
+        const double soa_ms = best_ms([&] {
+            s = table.count_age_between(30, 40);
+            do_not_optimize(s);
+        });
+        check(a, s, "age");
+        row("count 30 <= age < 40", aos_ms, soa_ms);
+    }
+    {
+        std::size_t a = 0, s = 0;
+        const double aos_ms = best_ms([&] {
+            a = 0;
+            for (const Person& p : aos) a += p.getName() == "Alice";
+            do_not_optimize(a);
+        });
+        const double soa_ms = best_ms([&] {
+            s = table.count_name("Alice");
+            do_not_optimize(s);
+        });
+        check(a, s, "name");
+        row("count name == \"Alice\"", aos_ms, soa_ms);
+    }
+    {
+        std::size_t a = 0, s = 0;
+        const double aos_ms = best_ms([&] {
+            a = 0;
+            for (const Person& p : aos) a += p.getName() == "Alice" && p.getAge() >= 30 && p.getAge() < 40;
+            do_not_optimize(a);
+        });
+        const double soa_ms = best_ms([&] {
+            s = table.count_name_and_age("Alice", 30, 40);
+            do_not_optimize(s);
+        });
+        check(a, s, "name and age");
+        row("count name == \"Alice\" && age", aos_ms, soa_ms);
+    }
+    {
+        std::vector<std::uint32_t> a;
+        std::vector<columnar::Row> s;
+        const double aos_ms = best_ms([&] {
+            a.clear();
+            for (std::size_t i = 0; i < aos.size(); ++i)
+                if (aos[i].getAge() >= 30 && aos[i].getAge() < 40) a.push_back(static_cast<std::uint32_t>(i));
+        });
+        const double soa_ms = best_ms([&] { s = table.select_age_between(30, 40); });
+        check(a.size(), s.size(), "select");
+        row("select rows 30 <= age < 40", aos_ms, soa_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// =======================================================
+// Arena / fixed-size pool / size-class pool as std::pmr::memory_resource
+//   RawOwner, ArrayOwner and Derived in destructorCases.cpp pay one
+//   new/delete per object. These resources hand out memory from large
+//   upstream blocks instead, and plug into any std::pmr container:
+//
+//     alloc::FixedPoolResource nodes(sizeof(Node));
+//     std::pmr::list<Node> list(&nodes);
+//
+//   ArenaResource      monotonic bump pointer; deallocate is a no-op, all
+//                      memory goes back at release()/destruction.
+//                      One thread at a time.
+//   FixedPoolResource  one block size; per-thread free lists, refilled
+//                      from / flushed to a shared list in batches. Any
+//                      thread may free a block another thread allocated.
+//   SizeClassResource  FixedPoolResources for 16..4096 bytes, upstream
+//                      for anything larger or over-aligned.
+//
+//   Pools keep their slabs until destruction (no per-block return to the
+//   OS), and a thread's cached blocks stay with the pool when it exits.
+//   A FixedPoolResource also keeps one small Cache per thread that used it
+//   until it is destroyed. Each thread finds its Cache in a thread-local
+//   table indexed by pool id; ids are recycled when a pool is destroyed,
+//   so the table (16 bytes a slot) only grows to the most pools alive at
+//   once, even when pools are created per request.
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall poolAllocatorsBench.cpp -pthread
+// =======================================================
+
+namespace alloc {
+
+constexpr std::size_t kAlign = alignof(std::max_align_t);
+
+inline std::size_t align_up(std::size_t n, std::size_t a) { return (n + a - 1) & ~(a - 1); }
+
+// =======================================================
+// Monotonic arena
+// =======================================================
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(std::size_t first_block = 64 * 1024,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : next_block_(std::max<std::size_t>(first_block, 256)), upstream_(upstream) {}
+
+    ~ArenaResource() override { release(); }
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    // Frees every block; everything allocated from the arena is gone.
+    void release() {
+        for (const Block& b : blocks_) upstream_->deallocate(b.p, b.size, kAlign);
+        blocks_.clear();
+        cur_ = end_ = nullptr;
+    }
+
+    std::size_t bytes_reserved() const noexcept {
+        std::size_t n = 0;
+        for (const Block& b : blocks_) n += b.size;
+        return n;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        auto p = reinterpret_cast<std::uintptr_t>(cur_);
+        auto aligned = align_up(p, align);
+        if (!cur_ || aligned + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+            grow(bytes + align);
+            aligned = align_up(reinterpret_cast<std::uintptr_t>(cur_), align);
+        }
+        cur_ = reinterpret_cast<char*>(aligned + bytes);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Block {
+        void* p;
+        std::size_t size;
+    };
+
+    // Geometric growth: the number of upstream calls is logarithmic in use.
+    void grow(std::size_t min_bytes) {
+        const std::size_t size = std::max(next_block_, align_up(min_bytes, kAlign));
+        void* p = upstream_->allocate(size, kAlign);
+        blocks_.push_back({p, size});
+        cur_ = static_cast<char*>(p);
+        end_ = cur_ + size;
+        next_block_ = size * 2;
+    }
+
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t next_block_;
+    std::pmr::memory_resource* upstream_;
+    std::vector<Block> blocks_;
+};
+
+// =======================================================
+// Fixed-size pool with per-thread caches
+// =======================================================
+class FixedPoolResource : public std::pmr::memory_resource {
+public:
+    // Blocks move between a thread cache and the shared list kBatch at a time.
+    static constexpr std::size_t kBatch = 64;
+
+    explicit FixedPoolResource(std::size_t block_size, std::size_t blocks_per_slab = 1024,
+                               std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : block_size_(align_up(std::max(block_size, sizeof(Node)), kAlign)),
+          blocks_per_slab_(align_up(std::max<std::size_t>(blocks_per_slab, kBatch), kBatch)),
+          upstream_(upstream),
+          id_(acquire_id()),
+          epoch_(next_epoch().fetch_add(1, std::memory_order_relaxed) + 1) {}
+
+    ~FixedPoolResource() override {
+        for (void* s : slabs_) upstream_->deallocate(s, block_size_ * blocks_per_slab_, kAlign);
+        release_id(id_);
+    }
+
+    FixedPoolResource(const FixedPoolResource&) = delete;
+    FixedPoolResource& operator=(const FixedPoolResource&) = delete;
+
+    std::size_t block_size() const noexcept { return block_size_; }
+
+    // Fast paths, usable without the virtual call.
+    void* allocate_block() {
+        Cache& c = cache();
+        if (!c.head) refill(c);
+        Node* n = c.head;
+        c.head = n->next;
+        --c.count;
+        return n;
+    }
+
+    void deallocate_block(void* p) noexcept {
+        Cache& c = cache();
+        auto* n = static_cast<Node*>(p);
+        n->next = c.head;
+        c.head = n;
+        if (++c.count >= 2 * kBatch) flush(c);
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        if (bytes > block_size_ || align > kAlign) return upstream_->allocate(bytes, align);
+        return allocate_block();
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        if (bytes > block_size_ || align > kAlign) return upstream_->deallocate(p, bytes, align);
+        deallocate_block(p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    struct Cache {
+        Node* head = nullptr;
+        std::size_t count = 0;
+    };
+
+    // A batch of kBatch blocks on the shared list, linked through `next`.
+    struct Batch {
+        Node* head;
+    };
+
+    // Ids of live pools; a destroyed pool's id goes back on the free list.
+    struct IdRegistry {
+        std::mutex mtx;
+        std::size_t next = 0;
+        std::vector<std::size_t> free;
+    };
+
+    static IdRegistry& ids() {
+        static IdRegistry r;
+        return r;
+    }
+
+    static std::size_t acquire_id() {
+        IdRegistry& r = ids();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        if (r.free.empty()) return r.next++;
+        const std::size_t id = r.free.back();
+        r.free.pop_back();
+        return id;
+    }
+
+    static void release_id(std::size_t id) noexcept {
+        IdRegistry& r = ids();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        try {
+            r.free.push_back(id);
+        } catch (const std::bad_alloc&) {
+            // The id is just not reused.
+        }
+    }
+
+    // Never reused: tells a slot of this pool from one left by an earlier
+    // pool with the same id.
+    static std::atomic<std::uint64_t>& next_epoch() {
+        static std::atomic<std::uint64_t> epoch{0};
+        return epoch;
+    }
+
+    struct Slot {
+        std::uint64_t epoch = 0;
+        Cache* cache = nullptr;
+    };
+
+    // Per-thread cache for this pool, found by pool id. A slot whose epoch
+    // differs belongs to a destroyed pool (its Cache is gone with it) and
+    // is simply overwritten.
+    Cache& cache() {
+        thread_local std::vector<Slot> by_id;
+        if (id_ < by_id.size() && by_id[id_].epoch == epoch_) [[likely]] return *by_id[id_].cache;
+        if (id_ >= by_id.size()) by_id.resize(id_ + 1);
+        std::lock_guard<std::mutex> lock(mtx_);
+        caches_.push_back(std::make_unique<Cache>());
+        by_id[id_] = {epoch_, caches_.back().get()};
+        return *by_id[id_].cache;
+    }
+
+    void refill(Cache& c) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!shared_.empty()) {
+            c.head = shared_.back().head;
+            c.count = kBatch;
+            shared_.pop_back();
+            return;
+        }
+        // Carve a new slab into batches; the first goes to this thread.
+        char* slab = static_cast<char*>(upstream_->allocate(block_size_ * blocks_per_slab_, kAlign));
+        slabs_.push_back(slab);
+        for (std::size_t b = blocks_per_slab_ / kBatch; b-- > 0;) {
+            Node* head = nullptr;
+            for (std::size_t i = kBatch; i-- > 0;) {
+                auto* n = reinterpret_cast<Node*>(slab + (b * kBatch + i) * block_size_);
+                n->next = head;
+                head = n;
+            }
+            if (b == 0) c.head = head;
+            else shared_.push_back({head});
+        }
+        c.count = kBatch;
+    }
+
+    // Keep kBatch blocks, hand the next kBatch to the shared list.
+    void flush(Cache& c) {
+        Node* keep_tail = c.head;
+        for (std::size_t i = 1; i < kBatch; ++i) keep_tail = keep_tail->next;
+        Node* give = keep_tail->next;
+        Node* give_tail = give;
+        for (std::size_t i = 1; i < kBatch; ++i) give_tail = give_tail->next;
+        keep_tail->next = give_tail->next;
+        give_tail->next = nullptr;
+        c.count -= kBatch;
+        std::lock_guard<std::mutex> lock(mtx_);
+        shared_.push_back({give});
+    }
+
+    const std::size_t block_size_;
+    const std::size_t blocks_per_slab_;
+    std::pmr::memory_resource* upstream_;
+    const std::size_t id_;
+    const std::uint64_t epoch_;
+
+    std::mutex mtx_;
+    std::vector<Batch> shared_;
+    std::vector<void*> slabs_;
+    std::vector<std::unique_ptr<Cache>> caches_;
+};
+
+// =======================================================
+// Size classes: 16-byte steps to 128, then 4 classes per power of two
+// up to 4096 (at most 25% internal waste above 128 bytes).
+// =======================================================
+class SizeClassResource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kMaxSize = 4096;
+
+    explicit SizeClassResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {
+        std::size_t size = 16;
+        while (size <= kMaxSize) {
+            pools_.push_back(std::make_unique<FixedPoolResource>(size, slab_blocks(size), upstream));
+            size += size < 128 ? 16 : size_step(size);
+        }
+        for (std::size_t i = 0, c = 0; i < lookup_.size(); ++i) {
+            const std::size_t bytes = i * 16;
+            while (pools_[c]->block_size() < bytes) ++c;
+            lookup_[i] = static_cast<std::uint8_t>(c);
+        }
+    }
+
+    SizeClassResource(const SizeClassResource&) = delete;
+    SizeClassResource& operator=(const SizeClassResource&) = delete;
+
+    std::size_t class_count() const noexcept { return pools_.size(); }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        if (bytes > kMaxSize || align > kAlign) return upstream_->allocate(bytes, align);
+        return pools_[class_of(bytes)]->allocate_block();
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        if (bytes > kMaxSize || align > kAlign) return upstream_->deallocate(p, bytes, align);
+        pools_[class_of(bytes)]->deallocate_block(p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    static std::size_t size_step(std::size_t size) {
+        std::size_t pow2 = 1;
+        while (pow2 * 2 <= size) pow2 *= 2;
+        return pow2 / 4;
+    }
+
+    // ~64KB slabs, at least kBatch blocks.
+    static std::size_t slab_blocks(std::size_t size) { return std::max<std::size_t>(64 * 1024 / size, 64); }
+
+    std::size_t class_of(std::size_t bytes) const noexcept { return lookup_[(bytes + 15) / 16]; }
+
+    std::pmr::memory_resource* upstream_;
+    std::vector<std::unique_ptr<FixedPoolResource>> pools_;
+    std::array<std::uint8_t, kMaxSize / 16 + 1> lookup_{};
+};
+
+} // namespace alloc
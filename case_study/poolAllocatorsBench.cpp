@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "poolAllocators.hpp"
+
+/* Usage
+./app              # all benchmarks, 1..hardware_concurrency() threads
+./app churn 8      # fixed-size object churn (RawOwner/Derived-style objects)
+./app mixed 8      # mixed sizes 16..512 bytes
+./app arena 8      # build-and-drop std::pmr containers
+
+Build: g++ -std=c++20 -O2 poolAllocatorsBench.cpp -pthread -o app
+*/
+
+using Clock = std::chrono::steady_clock;
+
+// A small record of the kind destructorCases.cpp news one at a time,
+// one cache line in size.
+struct Order {
+    std::uint64_t id;
+    std::uint32_t qty;
+    std::uint32_t flags;
+    double price;
+    char tag[40];
+};
+static_assert(sizeof(Order) == 64);
+
+struct Rng {
+    std::uint64_t s;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s);
+    }
+};
+
+// A backend returns the resource one thread should use: shared resources
+// hand every thread the same pointer, per-thread ones build their own.
+// nullptr means plain ::operator new / delete.
+struct Backend {
+    const char* name;
+    std::function<std::pmr::memory_resource*()> shared;   // called once per run
+    bool per_thread = false;                             // call again for each thread
+};
+
+static void* get(std::pmr::memory_resource* r, std::size_t n) {
+    return r ? r->allocate(n, alignof(std::max_align_t)) : ::operator new(n);
+}
+
+static void put(std::pmr::memory_resource* r, void* p, std::size_t n) {
+    if (r) r->deallocate(p, n, alignof(std::max_align_t));
+    else ::operator delete(p, n);
+}
+
+// Starts `threads` copies of body(tid, resource) together and returns Mops/s.
+template <class Body>
+static double timed_run(unsigned threads, const Backend& b, std::uint64_t ops_per_thread, Body body) {
+    std::pmr::memory_resource* shared = b.per_thread ? nullptr : b.shared();
+
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::pmr::memory_resource* r = b.per_thread ? b.shared() : shared;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(t, r);
+            if (b.per_thread) delete r;
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    auto t0 = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    const double s = std::chrono::duration<double>(Clock::now() - t0).count();
+    if (!b.per_thread) delete shared;
+    return ops_per_thread * threads / s / 1e6;
+}
+
+static std::vector<unsigned> thread_counts(unsigned max_threads) {
+    std::vector<unsigned> v;
+    for (unsigned t = 1; t < max_threads; t *= 2) v.push_back(t);
+    v.push_back(max_threads);
+    return v;
+}
+
+// One row per allocator, one column per thread count; run(threads, row).
+static void print_table(const char* title, const std::vector<const char*>& rows, unsigned max_threads,
+                        const std::function<double(unsigned, std::size_t)>& run) {
+    const auto counts = thread_counts(max_threads);
+    std::printf("\n[%s] Mops/s (higher is better)\n  %-28s", title, "allocator");
+    for (unsigned t : counts) std::printf(" %8uT", t);
+    std::printf("\n");
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        std::printf("  %-28s", rows[i]);
+        for (unsigned t : counts) std::printf(" %9.1f", run(t, i));
+        std::printf("\n");
+    }
+}
+
+static std::vector<const char*> names(const std::vector<Backend>& backends) {
+    std::vector<const char*> v;
+    for (const Backend& b : backends) v.push_back(b.name);
+    return v;
+}
+
+// Resources that std::pmr ships, for reference.
+static Backend std_sync_pool() {
+    return {"pmr::synchronized_pool", [] { return new std::pmr::synchronized_pool_resource(); }};
+}
+static Backend std_unsync_pool() {
+    return {"pmr::unsynchronized_pool/T", [] { return new std::pmr::unsynchronized_pool_resource(); }, true};
+}
+
+// =======================================================
+// 1) Fixed-size churn: each thread keeps 4096 live Orders and replaces a
+//    random one per op (destroy + construct), like a map of RawOwners.
+// =======================================================
+static void bench_churn(unsigned max_threads) {
+    constexpr std::size_t kLive = 4096;
+    constexpr std::uint64_t kOps = 2'000'000;
+
+    auto body = [](unsigned tid, std::pmr::memory_resource* r) {
+        Rng rng{0x9E3779B97F4A7C15ull + tid};
+        std::vector<Order*> live(kLive);
+        for (auto& p : live) p = new (get(r, sizeof(Order))) Order{};
+        for (std::uint64_t i = 0; i < kOps; ++i) {
+            Order*& slot = live[rng.next() % kLive];
+            slot->~Order();
+            put(r, slot, sizeof(Order));
+            slot = new (get(r, sizeof(Order))) Order{i, 1, 0, 1.0, {}};
+        }
+        for (Order* p : live) {
+            p->~Order();
+            put(r, p, sizeof(Order));
+        }
+    };
+
+    std::vector<Backend> backends = {
+        {"new/delete", [] { return nullptr; }},
+        {"alloc::FixedPoolResource", [] { return new alloc::FixedPoolResource(sizeof(Order)); }},
+        {"alloc::SizeClassResource", [] { return new alloc::SizeClassResource(); }},
+        std_sync_pool(),
+        std_unsync_pool(),
+    };
+    print_table("churn 64B objects", names(backends), max_threads,
+                [&](unsigned t, std::size_t i) { return timed_run(t, backends[i], kOps, body); });
+}
+
+// =======================================================
+// 2) Mixed sizes: same churn, sizes 16..512 bytes
+// =======================================================
+static void bench_mixed(unsigned max_threads) {
+    constexpr std::size_t kLive = 4096;
+    constexpr std::uint64_t kOps = 2'000'000;
+
+    auto body = [](unsigned tid, std::pmr::memory_resource* r) {
+        struct Live {
+            void* p;
+            std::size_t n;
+        };
+        Rng rng{0xD1B54A32D192ED03ull + tid};
+        auto size = [&] { return 16 + rng.next() % 497; };
+        std::vector<Live> live(kLive);
+        for (auto& l : live) {
+            l.n = size();
+            l.p = get(r, l.n);
+        }
+        for (std::uint64_t i = 0; i < kOps; ++i) {
+            Live& l = live[rng.next() % kLive];
+            put(r, l.p, l.n);
+            l.n = size();
+            l.p = get(r, l.n);
+            static_cast<char*>(l.p)[0] = 1;
+        }
+        for (auto& l : live) put(r, l.p, l.n);
+    };
+
+    std::vector<Backend> backends = {
+        {"new/delete", [] { return nullptr; }},
+        {"alloc::SizeClassResource", [] { return new alloc::SizeClassResource(); }},
+        std_sync_pool(),
+        std_unsync_pool(),
+    };
+    print_table("churn 16..512B", names(backends), max_threads,
+                [&](unsigned t, std::size_t i) { return timed_run(t, backends[i], kOps, body); });
+}
+
+// =======================================================
+// 3) Arena: build a list of ints and a vector of strings, then drop it
+//    all. With an arena every node is a pointer bump and the teardown is
+//    a handful of upstream frees.
+// =======================================================
+static void bench_arena(unsigned max_threads) {
+    constexpr int kRounds = 40;
+    constexpr int kItems = 20000;
+    constexpr std::uint64_t kOps = std::uint64_t(kRounds) * kItems * 2;
+
+    auto build = [](std::pmr::memory_resource* r) {
+        std::pmr::list<int> l(r);
+        std::pmr::vector<std::pmr::string> v(r);
+        for (int i = 0; i < kItems; ++i) {
+            l.push_back(i);
+            v.emplace_back("a string that does not fit in SSO #" + std::to_string(i));
+        }
+        return l.size() + v.size();
+    };
+
+    struct Arena {
+        const char* name;
+        std::function<std::unique_ptr<std::pmr::memory_resource>()> make;   // nullptr: default resource
+    };
+    const std::vector<Arena> arenas = {
+        {"new/delete", [] { return nullptr; }},
+        {"alloc::ArenaResource", [] { return std::make_unique<alloc::ArenaResource>(); }},
+        {"pmr::monotonic_buffer", [] { return std::make_unique<std::pmr::monotonic_buffer_resource>(); }},
+        {"alloc::SizeClassResource", [] { return std::make_unique<alloc::SizeClassResource>(); }},
+    };
+
+    std::vector<const char*> rows;
+    for (const Arena& a : arenas) rows.push_back(a.name);
+
+    // Every thread builds into its own arena, so the shared-resource slot is unused.
+    const Backend none{"", [] { return nullptr; }};
+    print_table("build+drop pmr::list<int> + pmr::vector<pmr::string>", rows, max_threads,
+                [&](unsigned t, std::size_t i) {
+                    return timed_run(t, none, kOps, [&](unsigned, std::pmr::memory_resource*) {
+                        std::size_t sink = 0;
+                        for (int round = 0; round < kRounds; ++round) {
+                            // A fresh arena per round: release is the whole teardown.
+                            auto res = arenas[i].make();
+                            sink += build(res ? res.get() : std::pmr::new_delete_resource());
+                        }
+                        if (sink != std::size_t(kRounds) * kItems * 2) std::abort();
+                    });
+                });
+}
+
+int main(int argc, char** argv) {
+    const std::string which = argc > 1 ? argv[1] : "all";
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    std::printf("threads: 1..%u (hardware_concurrency %u)\n", threads, std::thread::hardware_concurrency());
+    if (which == "all" || which == "churn") bench_churn(threads);
+    if (which == "all" || which == "mixed") bench_mixed(threads);
+    if (which == "all" || which == "arena") bench_arena(threads);
+    return 0;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// =======================================================
+// Sharded counter / gauge / histogram
+//   A drop-in for "lock a mutex around counter++" (see run_with_mutex in
+//   mutexTest.cpp). Writers touch only their own cache-line-aligned slot
+//   with a relaxed atomic, so there is no shared line to bounce between
+//   cores; readers sum all slots lazily.
+//
+//   Reads are not a snapshot: a value read while writers are active may
+//   miss increments that happen during the sum (each slot is exact).
+//
+// Build (example, C++20 for <bit>):
+//   g++ -std=c++20 -O2 -Wall mutexTest.cpp -pthread
+// =======================================================
+
+namespace sharded {
+
+constexpr std::size_t kCacheLine = 64;
+constexpr std::size_t kDefaultShards = 64;
+
+// Per-thread shard index, handed out round-robin the first time a thread
+// touches any sharded type. With more threads than shards two threads may
+// share a slot; that is still correct (the slot is atomic), just slower.
+inline std::size_t thread_shard() {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+template <typename T>
+struct alignas(kCacheLine) Slot {
+    std::atomic<T> value{0};
+};
+
+// =======================================================
+// Counter: monotonically increasing (requests, bytes, errors, ...)
+// =======================================================
+template <std::size_t Shards = kDefaultShards>
+class Counter {
+    static_assert(std::has_single_bit(Shards), "Shards must be a power of two");
+
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    void add(std::uint64_t n = 1) noexcept {
+        slots_[thread_shard() & (Shards - 1)].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Same spelling as the plain counter it replaces.
+    Counter& operator++() noexcept { add(1); return *this; }
+    void operator++(int) noexcept { add(1); }
+    Counter& operator+=(std::uint64_t n) noexcept { add(n); return *this; }
+
+    std::uint64_t load() const noexcept {
+        std::uint64_t sum = 0;
+        for (const auto& s : slots_) sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+    operator std::uint64_t() const noexcept { return load(); }
+
+    // Not atomic with respect to concurrent add(); meant for test setup.
+    void reset() noexcept {
+        for (auto& s : slots_) s.value.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<Slot<std::uint64_t>, Shards> slots_{};
+};
+
+// =======================================================
+// Gauge: goes up and down (in-flight requests, open connections, ...)
+//   Only relative updates can be sharded. A gauge that is `set` to an
+//   absolute value should stay a single std::atomic.
+// =======================================================
+template <std::size_t Shards = kDefaultShards>
+class Gauge {
+    static_assert(std::has_single_bit(Shards), "Shards must be a power of two");
+
+public:
+    Gauge() = default;
+    Gauge(const Gauge&) = delete;
+    Gauge& operator=(const Gauge&) = delete;
+
+    void add(std::int64_t n) noexcept {
+        slots_[thread_shard() & (Shards - 1)].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    void sub(std::int64_t n) noexcept { add(-n); }
+
+    Gauge& operator++() noexcept { add(1); return *this; }
+    Gauge& operator--() noexcept { add(-1); return *this; }
+    Gauge& operator+=(std::int64_t n) noexcept { add(n); return *this; }
+    Gauge& operator-=(std::int64_t n) noexcept { add(-n); return *this; }
+
+    // A thread may inc on one shard and another thread dec on a different
+    // one, so single slots can be negative; only the sum is meaningful.
+    std::int64_t load() const noexcept {
+        std::int64_t sum = 0;
+        for (const auto& s : slots_) sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+    operator std::int64_t() const noexcept { return load(); }
+
+private:
+    std::array<Slot<std::int64_t>, Shards> slots_{};
+};
+
+// =======================================================
+// Histogram: log2 buckets of unsigned values (latency in ns, sizes, ...)
+//   bucket 0 holds 0, bucket b (b >= 1) holds [2^(b-1), 2^b).
+// =======================================================
+struct HistogramSnapshot {
+    static constexpr std::size_t kBuckets = 65;
+
+    std::array<std::uint64_t, kBuckets> buckets{};
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+
+    double mean() const noexcept { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+
+    // Upper bound of the bucket holding quantile q (0..1): within 2x.
+    std::uint64_t percentile(double q) const noexcept {
+        if (count == 0) return 0;
+        const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(q * static_cast<double>(count)));
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            seen += buckets[b];
+            if (seen >= rank) return std::min(bucket_upper(b), max);
+        }
+        return max;
+    }
+
+    static std::uint64_t bucket_upper(std::size_t b) noexcept {
+        if (b == 0) return 0;
+        if (b >= 64) return std::numeric_limits<std::uint64_t>::max();
+        return (std::uint64_t{1} << b) - 1;
+    }
+};
+
+template <std::size_t Shards = kDefaultShards>
+class Histogram {
+    static_assert(std::has_single_bit(Shards), "Shards must be a power of two");
+
+public:
+    Histogram() = default;
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    static std::size_t bucket_of(std::uint64_t v) noexcept { return static_cast<std::size_t>(std::bit_width(v)); }
+
+    void record(std::uint64_t v) noexcept {
+        Shard& s = shards_[thread_shard() & (Shards - 1)];
+        s.buckets[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+        s.sum.fetch_add(v, std::memory_order_relaxed);
+        // Only this shard's writers race on max; a relaxed CAS loop is enough.
+        std::uint64_t cur = s.max.load(std::memory_order_relaxed);
+        while (v > cur && !s.max.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+    }
+
+    HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot out;
+        for (const auto& s : shards_) {
+            for (std::size_t b = 0; b < HistogramSnapshot::kBuckets; ++b) {
+                std::uint64_t n = s.buckets[b].load(std::memory_order_relaxed);
+                out.buckets[b] += n;
+                out.count += n;
+            }
+            out.sum += s.sum.load(std::memory_order_relaxed);
+            out.max = std::max(out.max, s.max.load(std::memory_order_relaxed));
+        }
+        return out;
+    }
+
+private:
+    struct alignas(kCacheLine) Shard {
+        std::array<std::atomic<std::uint64_t>, HistogramSnapshot::kBuckets> buckets{};
+        std::atomic<std::uint64_t> sum{0};
+        std::atomic<std::uint64_t> max{0};
+    };
+    std::array<Shard, Shards> shards_{};
+};
+
+} // namespace sharded
@@ -32,4 +32,8 @@ std::cout << add(3, 2.5); // error
 e.g.
 std::cout << add<double>(3, 2.5);
 
+Or give each argument its own type and return std::common_type_t<A, B>
+(expr::add in exprVector.hpp): add(3, 2.5) is then a double, and the same
+promotion applies element-wise to expr::Vec<int> + expr::Vec<double>.
+
 */
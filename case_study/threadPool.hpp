@@ -0,0 +1,516 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// =======================================================
+// Shared runtime: work-stealing executor
+//   - one Chase-Lev deque per worker (owner pushes/pops the bottom,
+//     idle workers steal from the top)
+//   - a bounded lock-free MPMC queue for tasks submitted from outside
+//   - submit() / async() -> std::future / parallel_for()
+//   - an exception escaping a submit()ed task goes to the executor's
+//     exception handler (default: report on stderr) instead of killing the
+//     worker; async() and parallel_for() deliver theirs to the caller.
+//
+// Instead of building a new std::vector<std::thread> per program (see
+// cpuOverflow.cpp, mutexTest.cpp), create one Executor and reuse it.
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall threadPoolBench.cpp -pthread
+// =======================================================
+
+namespace runtime {
+
+constexpr std::size_t kCacheLine = 64;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// =======================================================
+// Bounded MPMC queue (Vyukov): every cell carries a sequence number that
+// says whether it is ready for the next producer or the next consumer.
+// =======================================================
+template <typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+          cells_(new Cell[mask_ + 1]) {
+        for (std::size_t i = 0; i <= mask_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    bool try_push(T value) {
+        Cell* cell;
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        Cell* cell;
+        std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->data);
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    // Approximate; only for heuristics.
+    bool empty() const noexcept {
+        return enqueue_.load(std::memory_order_relaxed) == dequeue_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLine) std::atomic<std::size_t> enqueue_{0};
+    alignas(kCacheLine) std::atomic<std::size_t> dequeue_{0};
+};
+
+// =======================================================
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli 2013)
+//   push/pop: owner thread only. steal: any thread.
+//   Grows by doubling; old buffers are kept until destruction because a
+//   thief may still be reading one.
+// =======================================================
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "Deque holds trivially copyable items (e.g. pointers)");
+
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 256) {
+        buffers_.push_back(std::make_unique<Buffer>(std::bit_ceil(std::max<std::size_t>(capacity, 2))));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    void push(T item) {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<std::int64_t>(buf->mask)) buf = grow(buf, t, b);
+        buf->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    bool pop(T& out) {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buf = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {  // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = buf->get(b);
+        if (t == b) {  // last item: race with thieves
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    bool steal(T& out) {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+
+        Buffer* buf = buffer_.load(std::memory_order_acquire);
+        T item = buf->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;  // lost to the owner or another thief
+        }
+        out = item;
+        return true;
+    }
+
+    // Approximate; only for heuristics.
+    bool empty() const noexcept {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(std::size_t cap) : mask(cap - 1), items(new std::atomic<T>[cap]) {}
+        void put(std::int64_t i, T v) noexcept { items[static_cast<std::size_t>(i) & mask].store(v, std::memory_order_relaxed); }
+        T get(std::int64_t i) const noexcept { return items[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed); }
+
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+    };
+
+    Buffer* grow(Buffer* old, std::int64_t t, std::int64_t b) {
+        buffers_.push_back(std::make_unique<Buffer>((old->mask + 1) * 2));
+        Buffer* bigger = buffers_.back().get();
+        for (std::int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        buffer_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(kCacheLine) std::atomic<std::int64_t> top_{0};
+    alignas(kCacheLine) std::atomic<std::int64_t> bottom_{0};
+    alignas(kCacheLine) std::atomic<Buffer*> buffer_{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers_;  // owner only
+};
+
+// =======================================================
+// Executor
+// =======================================================
+class Executor {
+public:
+    struct WorkerStats {
+        std::uint64_t executed = 0;
+        std::uint64_t stolen = 0;
+    };
+
+    // threads = 0 means std::thread::hardware_concurrency().
+    explicit Executor(unsigned threads = 0, std::size_t inject_capacity = 4096)
+        : inject_(inject_capacity) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        workers_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) workers_.push_back(std::make_unique<Worker>());
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
+        }
+    }
+
+    // Runs every task already submitted, then joins the workers.
+    ~Executor() {
+        stopping_.store(true, std::memory_order_seq_cst);
+        wake(true);
+        for (auto& w : workers_) w->thread.join();
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    unsigned size() const noexcept { return static_cast<unsigned>(workers_.size()); }
+
+    // Fire and forget. From a worker of this executor the task goes to that
+    // worker's deque; from anywhere else it goes to the MPMC queue.
+    // Tasks should not throw (use async() for results and errors); one that
+    // does is reported to the exception handler and otherwise ignored.
+    template <typename F>
+    void submit(F&& f) {
+        enqueue(new TaskImpl<std::decay_t<F>>(std::forward<F>(f)));
+    }
+
+    template <typename F>
+    auto async(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        std::packaged_task<R()> task(std::forward<F>(f));
+        auto fut = task.get_future();
+        submit(std::move(task));
+        return fut;
+    }
+
+    // Calls body(i) for i in [begin, end). The range is split recursively
+    // down to `grain` items, so idle workers steal big halves first. The
+    // calling thread helps run tasks until everything finished; the first
+    // exception thrown by body is rethrown here.
+    template <typename Body>
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Body body) {
+        if (begin >= end) return;
+        grain = std::max<std::size_t>(grain, 1);
+
+        struct Shared {
+            std::atomic<std::size_t> pending{0};
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+            std::mutex mtx;
+        } shared;
+
+        // A range task runs the left half itself and spawns the right half.
+        struct Range {
+            Executor* ex;
+            Shared* shared;
+            Body* body;
+            std::size_t lo, hi, grain;
+
+            void operator()() const {
+                std::size_t l = lo, h = hi;
+                while (h - l > grain) {
+                    std::size_t mid = l + (h - l) / 2;
+                    shared->pending.fetch_add(1, std::memory_order_relaxed);
+                    ex->enqueue(new TaskImpl<Range>(Range{ex, shared, body, mid, h, grain}));
+                    h = mid;
+                }
+                if (!shared->failed.load(std::memory_order_relaxed)) {
+                    try {
+                        for (std::size_t i = l; i < h; ++i) (*body)(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(shared->mtx);
+                        if (!shared->error) shared->error = std::current_exception();
+                        shared->failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+                shared->pending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        };
+
+        shared.pending.store(1, std::memory_order_relaxed);
+        Range{this, &shared, &body, begin, end, grain}();
+        while (shared.pending.load(std::memory_order_acquire) != 0) {
+            if (!run_one()) cpu_relax();
+        }
+        if (shared.error) std::rethrow_exception(shared.error);
+    }
+
+    // Runs one pending task on the calling thread, if any. Lets a thread
+    // that waits on work from this executor help instead of blocking.
+    bool run_one() {
+        Task* task = nullptr;
+        const int self = current_index();
+        if (self >= 0 && workers_[self]->deque.pop(task)) {
+            execute(task, self);
+            return true;
+        }
+        if (inject_.try_pop(task) || steal_any(self, task)) {
+            execute(task, self);
+            return true;
+        }
+        return false;
+    }
+
+    // Called on the thread that ran the task, for every exception that
+    // escapes a submit()ed task. Must not throw (std::terminate if it does).
+    using ExceptionHandler = std::function<void(std::exception_ptr)>;
+
+    void set_exception_handler(ExceptionHandler handler) {
+        std::lock_guard<std::mutex> lock(handler_mtx_);
+        handler_ = std::move(handler);
+    }
+
+    std::uint64_t unhandled_exceptions() const noexcept { return unhandled_.load(std::memory_order_relaxed); }
+
+    std::vector<WorkerStats> stats() const {
+        std::vector<WorkerStats> out;
+        for (const auto& w : workers_) {
+            out.push_back({w->executed.load(std::memory_order_relaxed), w->stolen.load(std::memory_order_relaxed)});
+        }
+        return out;
+    }
+
+    void reset_stats() {
+        for (auto& w : workers_) {
+            w->executed.store(0, std::memory_order_relaxed);
+            w->stolen.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Task {
+        virtual ~Task() = default;
+        virtual void run() = 0;
+    };
+
+    template <typename F>
+    struct TaskImpl final : Task {
+        explicit TaskImpl(F f) : fn(std::move(f)) {}
+        void run() override { fn(); }
+        F fn;
+    };
+
+    struct alignas(kCacheLine) Worker {
+        WorkStealingDeque<Task*> deque;
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> stolen{0};
+        std::thread thread;
+    };
+
+    // Which worker of *this* executor the calling thread is (-1: none).
+    struct CurrentWorker {
+        const Executor* owner = nullptr;
+        int index = -1;
+    };
+    static CurrentWorker& current() {
+        thread_local CurrentWorker cw;
+        return cw;
+    }
+    int current_index() const {
+        const auto& cw = current();
+        return cw.owner == this ? cw.index : -1;
+    }
+
+    void enqueue(Task* task) {
+        const int self = current_index();
+        if (self >= 0) {
+            workers_[self]->deque.push(task);
+        } else {
+            // Backpressure: the MPMC queue is bounded; help drain it when full.
+            while (!inject_.try_push(task)) {
+                if (!run_one()) std::this_thread::yield();
+            }
+        }
+        wake(false);
+    }
+
+    // Never throws: a worker thread must survive a bad task, and run_one()
+    // inside parallel_for() must not unwind while its Range tasks still
+    // point at the caller's stack.
+    void execute(Task* task, int self) {
+        std::unique_ptr<Task> owned(task);
+        try {
+            owned->run();
+        } catch (...) {
+            on_task_exception(std::current_exception());
+        }
+        if (self >= 0) workers_[self]->executed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void on_task_exception(std::exception_ptr error) noexcept {
+        unhandled_.fetch_add(1, std::memory_order_relaxed);
+        ExceptionHandler handler;
+        {
+            std::lock_guard<std::mutex> lock(handler_mtx_);
+            handler = handler_;
+        }
+        if (handler) {
+            handler(error);
+            return;
+        }
+        try {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "runtime::Executor: task threw: %s\n", e.what());
+        } catch (...) {
+            std::fprintf(stderr, "runtime::Executor: task threw a non-std exception\n");
+        }
+    }
+
+    bool steal_any(int self, Task*& out) {
+        const std::size_t n = workers_.size();
+        thread_local std::minstd_rand rng(static_cast<unsigned>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+        const std::size_t start = rng() % n;
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t victim = (start + k) % n;
+            if (static_cast<int>(victim) == self) continue;
+            if (workers_[victim]->deque.steal(out)) {
+                if (self >= 0) workers_[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool has_visible_work() const {
+        if (!inject_.empty()) return true;
+        for (const auto& w : workers_) if (!w->deque.empty()) return true;
+        return false;
+    }
+
+    // Sleepers park on `epoch_`; producers bump it only if someone sleeps.
+    void wake(bool all) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) == 0 && !all) return;
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (all) epoch_.notify_all();
+        else epoch_.notify_one();
+    }
+
+    void worker_loop(int index) {
+        current() = {this, index};
+        for (;;) {
+            if (run_one()) continue;
+
+            // Spin briefly before parking: tasks often arrive in bursts.
+            bool found = false;
+            for (int i = 0; i < 64 && !found; ++i) {
+                cpu_relax();
+                found = has_visible_work();
+            }
+            if (found) continue;
+
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint32_t seen = epoch_.load(std::memory_order_seq_cst);
+            if (has_visible_work()) {
+                sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+                continue;
+            }
+            if (stopping_.load(std::memory_order_seq_cst)) {
+                sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+                return;
+            }
+            epoch_.wait(seen, std::memory_order_seq_cst);
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    MpmcQueue<Task*> inject_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    alignas(kCacheLine) std::atomic<std::uint32_t> epoch_{0};
+    alignas(kCacheLine) std::atomic<std::uint32_t> sleepers_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint64_t> unhandled_{0};
+    std::mutex handler_mtx_;
+    ExceptionHandler handler_;
+};
+
+} // namespace runtime
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "threadPool.hpp"
+
+/* Usage
+./app            # both benchmarks, hardware_concurrency() workers
+./app spawn 8    # task-spawn overhead with 8 workers
+./app skew 8     # skewed parallel-for: static split vs work stealing
+
+Build: g++ -std=c++20 -O2 threadPoolBench.cpp -pthread -o app
+*/
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ns(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// Same busy loop as cpuOverflow.cpp's load_worker; `units` scales the cost.
+static std::uint64_t spin(std::uint64_t units) {
+    volatile std::uint64_t x = units;
+    for (std::uint64_t i = 0; i < units * 64; ++i) x = x * 1664525u + 1013904223u;
+    return x;
+}
+
+// =======================================================
+// 1) Task-spawn overhead: empty tasks, ns per task
+// =======================================================
+static void bench_spawn(unsigned workers) {
+    constexpr int kThreadTasks = 2000;     // std::thread / std::async are slow
+    constexpr int kPoolTasks = 200000;
+
+    std::printf("\n[spawn] empty tasks, %u workers\n", workers);
+    std::printf("  %-34s %10s %12s\n", "method", "tasks", "ns/task");
+
+    auto report = [](const char* name, int n, double ns) {
+        std::printf("  %-34s %10d %12.1f\n", name, n, ns / n);
+    };
+
+    {
+        std::atomic<int> done{0};
+        auto t0 = Clock::now();
+        for (int i = 0; i < kThreadTasks; ++i) {
+            std::thread t([&] { done.fetch_add(1, std::memory_order_relaxed); });
+            t.join();
+        }
+        report("std::thread + join", kThreadTasks, elapsed_ns(t0));
+    }
+    {
+        std::atomic<int> done{0};
+        auto t0 = Clock::now();
+        std::vector<std::future<void>> futs;
+        futs.reserve(kThreadTasks);
+        for (int i = 0; i < kThreadTasks; ++i)
+            futs.push_back(std::async(std::launch::async, [&] { done.fetch_add(1, std::memory_order_relaxed); }));
+        for (auto& f : futs) f.get();
+        report("std::async(launch::async)", kThreadTasks, elapsed_ns(t0));
+    }
+
+    runtime::Executor ex(workers);
+    {
+        std::atomic<int> done{0};
+        auto t0 = Clock::now();
+        for (int i = 0; i < kPoolTasks; ++i) ex.submit([&] { done.fetch_add(1, std::memory_order_relaxed); });
+        while (done.load(std::memory_order_acquire) != kPoolTasks) {
+            if (!ex.run_one()) runtime::cpu_relax();
+        }
+        report("Executor::submit (external, MPMC)", kPoolTasks, elapsed_ns(t0));
+    }
+    {
+        auto t0 = Clock::now();
+        std::vector<std::future<int>> futs;
+        futs.reserve(kPoolTasks);
+        for (int i = 0; i < kPoolTasks; ++i) futs.push_back(ex.async([i] { return i; }));
+        long long sum = 0;
+        for (auto& f : futs) sum += f.get();
+        report("Executor::async + future", kPoolTasks, elapsed_ns(t0));
+        if (sum < 0) std::puts("unreachable");
+    }
+    {
+        // Spawned from inside workers: tasks go to the local deques.
+        std::atomic<int> done{0};
+        auto t0 = Clock::now();
+        ex.parallel_for(0, kPoolTasks, 1, [&](std::size_t) { done.fetch_add(1, std::memory_order_relaxed); });
+        report("Executor::parallel_for grain=1", kPoolTasks, elapsed_ns(t0));
+    }
+}
+
+// =======================================================
+// 2) Load balance on skewed work
+//   item i costs (i * i / n) units: the last quarter of the range holds
+//   more than half of the total work, so a contiguous static split leaves
+//   most threads idle while the last one finishes.
+//   "max share" = largest fraction of all work units done by one thread
+//   (ideal: 1 / threads).
+// =======================================================
+struct alignas(runtime::kCacheLine) Units {
+    std::atomic<std::uint64_t> value{0};
+};
+
+static std::size_t thread_slot() {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+static double max_share(std::vector<Units>& units) {
+    std::uint64_t mx = 0, total = 0;
+    for (auto& u : units) {
+        std::uint64_t v = u.value.exchange(0, std::memory_order_relaxed);
+        mx = std::max(mx, v);
+        total += v;
+    }
+    return total ? static_cast<double>(mx) / static_cast<double>(total) : 0.0;
+}
+
+static void bench_skew(unsigned workers) {
+    constexpr std::size_t n = 1 << 12;
+    auto cost = [](std::size_t i) { return static_cast<std::uint64_t>(i) * i / n; };
+
+    std::printf("\n[skew] %zu items, cost(i) = i^2/n, %u threads (ideal max share %.0f%%)\n",
+                n, workers, 100.0 / workers);
+    std::printf("  %-30s %10s %10s %8s\n", "method", "ms", "max share", "steals");
+
+    std::vector<Units> units(256);
+    auto work = [&](std::size_t i) {
+        std::uint64_t c = cost(i);
+        units[thread_slot() % units.size()].value.fetch_add(c, std::memory_order_relaxed);
+        return spin(c);
+    };
+    std::atomic<std::uint64_t> sink{0};
+
+    // Ad-hoc pool: contiguous chunks, one std::thread each.
+    {
+        std::vector<std::thread> pool;
+        auto t0 = Clock::now();
+        for (unsigned w = 0; w < workers; ++w) {
+            pool.emplace_back([&, w] {
+                std::uint64_t acc = 0;
+                for (std::size_t i = n * w / workers; i < n * (w + 1) / workers; ++i) acc += work(i);
+                sink.fetch_add(acc, std::memory_order_relaxed);
+            });
+        }
+        for (auto& t : pool) t.join();
+        double ms = elapsed_ns(t0) / 1e6;
+        std::printf("  %-30s %10.1f %9.0f%% %8s\n", "static split (vector<thread>)", ms, 100 * max_share(units), "-");
+    }
+
+    runtime::Executor ex(workers);
+    for (std::size_t grain : {std::size_t{1024}, std::size_t{64}, std::size_t{8}}) {
+        ex.reset_stats();
+        auto t0 = Clock::now();
+        ex.parallel_for(0, n, grain, [&](std::size_t i) { sink.fetch_add(work(i), std::memory_order_relaxed); });
+        double ms = elapsed_ns(t0) / 1e6;
+
+        std::uint64_t stolen = 0;
+        for (const auto& s : ex.stats()) stolen += s.stolen;
+        std::string name = "Executor grain=" + std::to_string(grain);
+        std::printf("  %-30s %10.1f %9.0f%% %8llu\n", name.c_str(), ms, 100 * max_share(units),
+                    static_cast<unsigned long long>(stolen));
+    }
+
+    if (sink.load() == 42) std::puts("");
+}
+
+int main(int argc, char** argv) {
+    std::string mode = (argc > 1) ? argv[1] : "all";
+    unsigned workers = (argc > 2) ? static_cast<unsigned>(std::stoul(argv[2])) : std::thread::hardware_concurrency();
+    workers = std::max(1u, workers);
+
+    if (mode == "spawn" || mode == "all") bench_spawn(workers);
+    if (mode == "skew" || mode == "all") bench_skew(workers);
+    if (mode != "all" && mode != "spawn" && mode != "skew") {
+        std::cerr << "unknown mode: " << mode << " (spawn | skew)\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+#include "threadPool.hpp"
+
+// =======================================================
+// Exception checks for runtime::Executor
+//   - a submit()ed task that throws reaches the exception handler and the
+//     worker keeps running;
+//   - parallel_for's calling thread helps with a foreign task that throws:
+//     parallel_for must still finish normally (run under ASan to be sure
+//     nothing touches its stack frame afterwards);
+//   - an exception from parallel_for's own body still reaches its caller.
+//   Exits non-zero on failure.
+//
+// Build/run (example):
+//   g++ -std=c++20 -O1 -g -fsanitize=address threadPoolCheck.cpp -pthread && ./a.out
+// =======================================================
+
+static bool report(const char* what, bool ok) {
+    std::printf("%-52s %s\n", what, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+
+    // 1) submit() + throw, one worker.
+    {
+        runtime::Executor ex(1);
+        std::atomic<int> handled{0};
+        ex.set_exception_handler([&](std::exception_ptr) { handled.fetch_add(1); });
+
+        std::atomic<int> ran_after{0};
+        ex.submit([] { throw std::runtime_error("task failed"); });
+        ex.submit([&] { ran_after.fetch_add(1); });
+        auto fut = ex.async([] { return 42; });
+        const bool got = fut.get() == 42;
+
+        ok &= report("submit: handler saw the exception", handled.load() == 1);
+        ok &= report("submit: worker kept running", got && ran_after.load() == 1);
+        ok &= report("submit: unhandled_exceptions() == 1", ex.unhandled_exceptions() == 1);
+    }
+
+    // 2) parallel_for helping with a foreign throwing task. The only worker
+    //    is parked on `release`, so the throwing tasks in the MPMC queue can
+    //    only be run by parallel_for's help loop on this thread.
+    {
+        runtime::Executor ex(1);
+        std::atomic<int> handled{0};
+        ex.set_exception_handler([&](std::exception_ptr) { handled.fetch_add(1); });
+
+        std::atomic<bool> parked{false}, release{false};
+        ex.submit([&] {
+            parked.store(true);
+            while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+        while (!parked.load()) std::this_thread::yield();
+        for (int i = 0; i < 4; ++i) ex.submit([] { throw std::runtime_error("foreign task failed"); });
+
+        std::atomic<std::size_t> sum{0};
+        bool threw = false;
+        try {
+            ex.parallel_for(0, 1000, 10, [&](std::size_t i) { sum.fetch_add(i); });
+        } catch (...) {
+            threw = true;
+        }
+        release.store(true);
+
+        ok &= report("parallel_for: foreign exceptions did not escape", !threw);
+        ok &= report("parallel_for: every index ran", sum.load() == 999 * 1000 / 2);
+        ok &= report("parallel_for: handler saw all foreign exceptions", handled.load() == 4);
+    }
+
+    // 3) parallel_for's own body still reports to the caller.
+    {
+        runtime::Executor ex(2);
+        bool caught = false;
+        try {
+            ex.parallel_for(0, 1000, 10, [](std::size_t i) {
+                if (i == 500) throw std::runtime_error("body failed");
+            });
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        ok &= report("parallel_for: body exception rethrown to caller", caught);
+        ok &= report("parallel_for: body exception not sent to the handler", ex.unhandled_exceptions() == 0);
+    }
+
+    std::printf(ok ? "PASS: executor exception handling\n" : "FAIL: executor exception handling\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,1043 @@
+#pragma once
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
+#include <openssl/rand.h>
+#include <pthread.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// =======================================================
+// AES-256-GCM helpers shared by AES.cpp and AESBench.cpp
+//
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall AES.cpp -lcrypto
+// =======================================================
+
+inline void throwIf(bool cond, const char* msg) {
+    if (cond) throw std::runtime_error(msg);
+}
+
+struct GcmEncrypted {
+    std::vector<unsigned char> nonce;      // 12 bytes
+    std::vector<unsigned char> ciphertext; // same length as plaintext
+    std::vector<unsigned char> tag;        // 16 bytes
+};
+
+// =======================================================
+// Nonce generation without RAND_bytes per message
+//   nonce = random prefix (8 bytes) || counter (4 bytes, big-endian)
+//   Each GcmNonceSequence (one per thread for the per-call functions, one
+//   per GcmSession) draws prefix and starting counter with one 12-byte
+//   RAND_bytes, so its first nonce is as random as the classic per-message
+//   draw; later ones only step the counter. A new draw happens every 2^32
+//   messages and after fork(), so RAND_bytes (and its DRBG lock) is hit
+//   once per sequence instead of once per message.
+// =======================================================
+
+// Per-key message budget shared by every thread using that key. Threads
+// reserve blocks of kBlock messages, so the shared atomic is touched once
+// per block. Reserved-but-unused messages still count (conservative).
+class GcmKeyUsage {
+public:
+    static constexpr std::uint64_t kBlock = 4096;
+
+    // Default limit: 2^32 messages per key (SP 800-38D, 8.3).
+    explicit GcmKeyUsage(std::uint64_t max_messages = 1ULL << 32, double rekey_fraction = 0.9)
+        : max_(max_messages),
+          rekey_at_(static_cast<std::uint64_t>(static_cast<double>(max_messages) * rekey_fraction)) {}
+
+    // Grants up to n messages; 0 means the key is used up.
+    std::uint64_t reserve(std::uint64_t n) {
+        std::uint64_t start = reserved_.fetch_add(n, std::memory_order_relaxed);
+        if (start >= max_) return 0;
+        return std::min(n, max_ - start);
+    }
+
+    // Rekey signal: set once usage crosses rekey_fraction of the limit.
+    bool needs_rekey() const noexcept { return used() >= rekey_at_; }
+    std::uint64_t used() const noexcept {
+        return std::min(reserved_.load(std::memory_order_relaxed), max_);
+    }
+    std::uint64_t limit() const noexcept { return max_; }
+
+private:
+    std::atomic<std::uint64_t> reserved_{0};
+    const std::uint64_t max_;
+    const std::uint64_t rekey_at_;
+};
+
+// Bumped in every fork()ed child. A child inherits its parent's nonce
+// sequences byte for byte, so each sequence compares this against the value
+// it last saw and draws a fresh prefix when they differ.
+inline std::uint64_t gcm_fork_generation() noexcept {
+    static std::atomic<std::uint64_t> generation{0};
+    static const bool registered = [] {
+        ::pthread_atfork(nullptr, nullptr, [] { generation.fetch_add(1, std::memory_order_relaxed); });
+        return true;
+    }();
+    (void)registered;
+    return generation.load(std::memory_order_relaxed);
+}
+
+// Per-thread nonce source (not thread-safe, like GcmSession).
+class GcmNonceSequence {
+public:
+    // Without a shared GcmKeyUsage there is no per-key limit.
+    explicit GcmNonceSequence(std::shared_ptr<GcmKeyUsage> usage = nullptr)
+        : usage_(std::move(usage)), fork_generation_(gcm_fork_generation()) {}
+
+    // Writes a 12-byte nonce. Throws once the key's message limit is reached.
+    void next(std::span<unsigned char> nonce) {
+        throwIf(nonce.size() != 12, "Nonce should be 12 bytes for AES-GCM");
+        if (usage_ && granted_ == 0) {
+            granted_ = usage_->reserve(GcmKeyUsage::kBlock);
+            throwIf(granted_ == 0, "Per-key message limit reached: rekey required");
+        }
+        if (const auto gen = gcm_fork_generation(); gen != fork_generation_) {
+            fork_generation_ = gen;
+            remaining_in_prefix_ = 0;  // same prefix and counter as the parent otherwise
+        }
+        if (remaining_in_prefix_ == 0) {
+            // Random starting counter too: a sequence used for one message
+            // (a short-lived session) still gets a full 96-bit random nonce.
+            unsigned char fresh[12];
+            throwIf(RAND_bytes(fresh, sizeof fresh) != 1, "RAND_bytes failed");
+            std::memcpy(prefix_, fresh, sizeof prefix_);
+            std::memcpy(&counter_, fresh + sizeof prefix_, sizeof counter_);
+            remaining_in_prefix_ = 1ULL << 32;  // counter wraps back to its start after this many
+        }
+
+        std::memcpy(nonce.data(), prefix_, sizeof prefix_);
+        nonce[8] = static_cast<unsigned char>(counter_ >> 24);
+        nonce[9] = static_cast<unsigned char>(counter_ >> 16);
+        nonce[10] = static_cast<unsigned char>(counter_ >> 8);
+        nonce[11] = static_cast<unsigned char>(counter_);
+
+        counter_++;
+        remaining_in_prefix_--;
+        if (usage_) granted_--;
+    }
+
+    bool needs_rekey() const noexcept { return usage_ && usage_->needs_rekey(); }
+    bool draws_from(const GcmKeyUsage* usage) const noexcept { return usage_.get() == usage; }
+
+private:
+    std::shared_ptr<GcmKeyUsage> usage_;
+    unsigned char prefix_[8] = {};
+    std::uint32_t counter_ = 0;
+    std::uint64_t remaining_in_prefix_ = 0;
+    std::uint64_t granted_ = 0;
+    std::uint64_t fork_generation_;
+};
+
+// Process-wide GcmKeyUsage per key ID, so every thread's session for the
+// same key draws from one budget. Only touched when a session is created.
+struct GcmKeyUsageRegistry {
+    std::mutex mtx;
+    std::unordered_map<std::string, std::shared_ptr<GcmKeyUsage>> usage;
+};
+
+inline GcmKeyUsageRegistry& gcm_key_usage_registry() {
+    static GcmKeyUsageRegistry registry;
+    return registry;
+}
+
+inline std::shared_ptr<GcmKeyUsage> gcm_key_usage(const std::string& key_id) {
+    auto& reg = gcm_key_usage_registry();
+    std::lock_guard<std::mutex> lock(reg.mtx);
+    auto& slot = reg.usage[key_id];
+    if (!slot) slot = std::make_shared<GcmKeyUsage>();
+    return slot;
+}
+
+// Call after the key behind key_id was rotated: the next sessions created
+// for it start from a fresh budget (and forget(key_id) drops the old ones).
+inline void gcm_key_usage_reset(const std::string& key_id) {
+    auto& reg = gcm_key_usage_registry();
+    std::lock_guard<std::mutex> lock(reg.mtx);
+    reg.usage.erase(key_id);
+}
+
+// True once key_id has used rekey_fraction of its budget, counting sessions
+// and per-call functions that were given the same key_id.
+inline bool gcm_needs_rekey(const std::string& key_id) { return gcm_key_usage(key_id)->needs_rekey(); }
+
+// Nonces for the per-call functions below. Without a key ID they have no
+// key budget: nothing tells them which calls share a key.
+inline GcmNonceSequence& thread_nonce_sequence() {
+    thread_local GcmNonceSequence seq;
+    return seq;
+}
+
+// With a key ID the calls draw from gcm_key_usage(key_id) like a cached
+// session, and throw once its limit is reached. One sequence per key ID
+// and thread; a gcm_key_usage_reset(key_id) starts a new one.
+inline GcmNonceSequence& thread_nonce_sequence(const std::string& key_id) {
+    if (key_id.empty()) return thread_nonce_sequence();
+    thread_local std::unordered_map<std::string, GcmNonceSequence> seqs;
+    auto usage = gcm_key_usage(key_id);
+    auto it = seqs.find(key_id);
+    if (it == seqs.end() || !it->second.draws_from(usage.get())) {
+        it = seqs.insert_or_assign(key_id, GcmNonceSequence(std::move(usage))).first;
+    }
+    return it->second;
+}
+
+// Pass key_id to count the message against that key's budget (see
+// gcm_needs_rekey); an empty key_id means no limit is enforced.
+inline GcmEncrypted aes256_gcm_encrypt(const std::vector<unsigned char>& key,
+                                      const std::vector<unsigned char>& plaintext,
+                                      const std::vector<unsigned char>& aad = {},
+                                      const std::string& key_id = {}) {
+    throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+    GcmEncrypted out;
+    out.nonce.resize(12);
+    out.tag.resize(16);
+    out.ciphertext.resize(plaintext.size());
+
+    thread_nonce_sequence(key_id).next(out.nonce);
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    throwIf(!ctx, "EVP_CIPHER_CTX_new failed");
+
+    int len = 0;
+    int ciphertext_len = 0;
+
+    try {
+        throwIf(EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1,
+                "EncryptInit (cipher) failed");
+
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, (int)out.nonce.size(), nullptr) != 1,
+                "SET_IVLEN failed");
+
+        throwIf(EVP_EncryptInit_ex(ctx, nullptr, nullptr, key.data(), out.nonce.data()) != 1,
+                "EncryptInit (key/iv) failed");
+
+        // Optional AAD (authenticated but not encrypted)
+        if (!aad.empty()) {
+            throwIf(EVP_EncryptUpdate(ctx, nullptr, &len, aad.data(), (int)aad.size()) != 1,
+                    "EncryptUpdate (AAD) failed");
+        }
+
+        if (!plaintext.empty()) {
+            throwIf(EVP_EncryptUpdate(ctx, out.ciphertext.data(), &len,
+                                      plaintext.data(), (int)plaintext.size()) != 1,
+                    "EncryptUpdate (pt) failed");
+            ciphertext_len = len;
+        }
+
+        // Finalize (GCM doesn't output more data here typically, but still call it)
+        throwIf(EVP_EncryptFinal_ex(ctx, out.ciphertext.data() + ciphertext_len, &len) != 1,
+                "EncryptFinal failed");
+        ciphertext_len += len;
+        out.ciphertext.resize(ciphertext_len);
+
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, (int)out.tag.size(), out.tag.data()) != 1,
+                "GET_TAG failed");
+
+        EVP_CIPHER_CTX_free(ctx);
+        return out;
+    } catch (...) {
+        EVP_CIPHER_CTX_free(ctx);
+        throw;
+    }
+}
+
+inline std::vector<unsigned char> aes256_gcm_decrypt(const std::vector<unsigned char>& key,
+                                                    const std::vector<unsigned char>& nonce,
+                                                    const std::vector<unsigned char>& ciphertext,
+                                                    const std::vector<unsigned char>& tag,
+                                                    const std::vector<unsigned char>& aad = {}) {
+    throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+    throwIf(nonce.size() != 12, "Nonce should be 12 bytes for AES-GCM");
+    throwIf(tag.size() != 16, "Tag must be 16 bytes (recommended) for AES-GCM");
+
+    std::vector<unsigned char> plaintext(ciphertext.size());
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    throwIf(!ctx, "EVP_CIPHER_CTX_new failed");
+
+    int len = 0;
+    int plaintext_len = 0;
+
+    try {
+        throwIf(EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1,
+                "DecryptInit (cipher) failed");
+
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, (int)nonce.size(), nullptr) != 1,
+                "SET_IVLEN failed");
+
+        throwIf(EVP_DecryptInit_ex(ctx, nullptr, nullptr, key.data(), nonce.data()) != 1,
+                "DecryptInit (key/iv) failed");
+
+        if (!aad.empty()) {
+            throwIf(EVP_DecryptUpdate(ctx, nullptr, &len, aad.data(), (int)aad.size()) != 1,
+                    "DecryptUpdate (AAD) failed");
+        }
+
+        if (!ciphertext.empty()) {
+            throwIf(EVP_DecryptUpdate(ctx, plaintext.data(), &len,
+                                      ciphertext.data(), (int)ciphertext.size()) != 1,
+                    "DecryptUpdate (ct) failed");
+            plaintext_len = len;
+        }
+
+        // Set expected tag BEFORE final
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, (int)tag.size(), (void*)tag.data()) != 1,
+                "SET_TAG failed");
+
+        // Final returns 1 if tag verifies; 0 otherwise
+        int ok = EVP_DecryptFinal_ex(ctx, plaintext.data() + plaintext_len, &len);
+        throwIf(ok != 1, "DecryptFinal failed: tag mismatch (tampered or wrong key/nonce/tag)");
+
+        plaintext_len += len;
+        plaintext.resize(plaintext_len);
+
+        EVP_CIPHER_CTX_free(ctx);
+        return plaintext;
+    } catch (...) {
+        EVP_CIPHER_CTX_free(ctx);
+        throw;
+    }
+}
+
+// =======================================================
+// Streaming (incremental) AES-256-GCM
+//   init(key, nonce, aad) -> update(in, out)* -> finalize()
+//   Memory stays constant: the caller owns the fixed-size buffers.
+// =======================================================
+
+struct CipherCtxFree {
+    void operator()(EVP_CIPHER_CTX* ctx) const noexcept { EVP_CIPHER_CTX_free(ctx); }
+};
+using CipherCtxPtr = std::unique_ptr<EVP_CIPHER_CTX, CipherCtxFree>;
+
+// NIST SP 800-38D: one (key, nonce) pair may protect at most 2^39 - 256 bits.
+constexpr std::uint64_t kGcmMaxPlaintextBytes = ((1ULL << 39) - 256) / 8;
+
+// EVP_*Update takes an int length, so large spans are fed in pieces.
+constexpr std::size_t kEvpMaxChunk = static_cast<std::size_t>(INT_MAX) & ~std::size_t{15};
+
+class GcmStreamEncryptor {
+public:
+    GcmStreamEncryptor() = default;
+    GcmStreamEncryptor(std::span<const unsigned char> key,
+                       std::span<const unsigned char> nonce,
+                       std::span<const unsigned char> aad = {}) {
+        init(key, nonce, aad);
+    }
+
+    // May be called again to start a new message on the same object.
+    void init(std::span<const unsigned char> key,
+              std::span<const unsigned char> nonce,
+              std::span<const unsigned char> aad = {}) {
+        throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+        throwIf(nonce.size() != 12, "Nonce should be 12 bytes for AES-GCM");
+
+        if (!ctx_) ctx_.reset(EVP_CIPHER_CTX_new());
+        throwIf(!ctx_, "EVP_CIPHER_CTX_new failed");
+
+        throwIf(EVP_EncryptInit_ex(ctx_.get(), EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1,
+                "EncryptInit (cipher) failed");
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx_.get(), EVP_CTRL_GCM_SET_IVLEN, (int)nonce.size(), nullptr) != 1,
+                "SET_IVLEN failed");
+        throwIf(EVP_EncryptInit_ex(ctx_.get(), nullptr, nullptr, key.data(), nonce.data()) != 1,
+                "EncryptInit (key/iv) failed");
+
+        int len = 0;
+        if (!aad.empty()) {
+            throwIf(EVP_EncryptUpdate(ctx_.get(), nullptr, &len, aad.data(), (int)aad.size()) != 1,
+                    "EncryptUpdate (AAD) failed");
+        }
+        processed_ = 0;
+        active_ = true;
+    }
+
+    // Encrypts `in` into `out` (out.size() >= in.size(); in == out is allowed).
+    // Returns the number of bytes written, which for GCM is always in.size().
+    std::size_t update(std::span<const unsigned char> in, std::span<unsigned char> out) {
+        throwIf(!active_, "update() called before init() or after finalize()");
+        throwIf(out.size() < in.size(), "Output span smaller than input span");
+        throwIf(in.size() > kGcmMaxPlaintextBytes - processed_, "GCM message length limit exceeded");
+
+        std::size_t written = 0;
+        while (written < in.size()) {
+            std::size_t n = std::min(in.size() - written, kEvpMaxChunk);
+            int len = 0;
+            throwIf(EVP_EncryptUpdate(ctx_.get(), out.data() + written, &len,
+                                      in.data() + written, (int)n) != 1,
+                    "EncryptUpdate (pt) failed");
+            written += static_cast<std::size_t>(len);
+        }
+        processed_ += written;
+        return written;
+    }
+
+    std::array<unsigned char, 16> finalize() {
+        throwIf(!active_, "finalize() called before init()");
+        active_ = false;
+
+        unsigned char dummy[16];
+        int len = 0;
+        throwIf(EVP_EncryptFinal_ex(ctx_.get(), dummy, &len) != 1, "EncryptFinal failed");
+
+        std::array<unsigned char, 16> tag{};
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx_.get(), EVP_CTRL_GCM_GET_TAG, (int)tag.size(), tag.data()) != 1,
+                "GET_TAG failed");
+        return tag;
+    }
+
+    std::uint64_t bytesProcessed() const noexcept { return processed_; }
+
+private:
+    CipherCtxPtr ctx_;
+    std::uint64_t processed_ = 0;
+    bool active_ = false;
+};
+
+// NOTE: update() releases plaintext BEFORE the tag is checked.
+// The caller must treat everything it wrote as untrusted (and discard it)
+// unless finalize() returns without throwing.
+class GcmStreamDecryptor {
+public:
+    GcmStreamDecryptor() = default;
+    GcmStreamDecryptor(std::span<const unsigned char> key,
+                       std::span<const unsigned char> nonce,
+                       std::span<const unsigned char> aad = {}) {
+        init(key, nonce, aad);
+    }
+
+    void init(std::span<const unsigned char> key,
+              std::span<const unsigned char> nonce,
+              std::span<const unsigned char> aad = {}) {
+        throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+        throwIf(nonce.size() != 12, "Nonce should be 12 bytes for AES-GCM");
+
+        if (!ctx_) ctx_.reset(EVP_CIPHER_CTX_new());
+        throwIf(!ctx_, "EVP_CIPHER_CTX_new failed");
+
+        throwIf(EVP_DecryptInit_ex(ctx_.get(), EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1,
+                "DecryptInit (cipher) failed");
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx_.get(), EVP_CTRL_GCM_SET_IVLEN, (int)nonce.size(), nullptr) != 1,
+                "SET_IVLEN failed");
+        throwIf(EVP_DecryptInit_ex(ctx_.get(), nullptr, nullptr, key.data(), nonce.data()) != 1,
+                "DecryptInit (key/iv) failed");
+
+        int len = 0;
+        if (!aad.empty()) {
+            throwIf(EVP_DecryptUpdate(ctx_.get(), nullptr, &len, aad.data(), (int)aad.size()) != 1,
+                    "DecryptUpdate (AAD) failed");
+        }
+        processed_ = 0;
+        active_ = true;
+    }
+
+    std::size_t update(std::span<const unsigned char> in, std::span<unsigned char> out) {
+        throwIf(!active_, "update() called before init() or after finalize()");
+        throwIf(out.size() < in.size(), "Output span smaller than input span");
+        throwIf(in.size() > kGcmMaxPlaintextBytes - processed_, "GCM message length limit exceeded");
+
+        std::size_t written = 0;
+        while (written < in.size()) {
+            std::size_t n = std::min(in.size() - written, kEvpMaxChunk);
+            int len = 0;
+            throwIf(EVP_DecryptUpdate(ctx_.get(), out.data() + written, &len,
+                                      in.data() + written, (int)n) != 1,
+                    "DecryptUpdate (ct) failed");
+            written += static_cast<std::size_t>(len);
+        }
+        processed_ += written;
+        return written;
+    }
+
+    // Throws if the tag does not verify.
+    void finalize(std::span<const unsigned char> tag) {
+        throwIf(!active_, "finalize() called before init()");
+        throwIf(tag.size() != 16, "Tag must be 16 bytes (recommended) for AES-GCM");
+        active_ = false;
+
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx_.get(), EVP_CTRL_GCM_SET_TAG, (int)tag.size(),
+                                    const_cast<unsigned char*>(tag.data())) != 1,
+                "SET_TAG failed");
+
+        unsigned char dummy[16];
+        int len = 0;
+        int ok = EVP_DecryptFinal_ex(ctx_.get(), dummy, &len);
+        throwIf(ok != 1, "DecryptFinal failed: tag mismatch (tampered or wrong key/nonce/tag)");
+    }
+
+    std::uint64_t bytesProcessed() const noexcept { return processed_; }
+
+private:
+    CipherCtxPtr ctx_;
+    std::uint64_t processed_ = 0;
+    bool active_ = false;
+};
+
+// Packed wire format used by the span API: nonce(12) || ciphertext || tag(16)
+constexpr std::size_t kGcmNonceBytes = 12;
+constexpr std::size_t kGcmTagBytes = 16;
+constexpr std::size_t kGcmPackedOverhead = kGcmNonceBytes + kGcmTagBytes;
+
+struct GcmPackedView {
+    std::span<const unsigned char> nonce;
+    std::span<const unsigned char> ciphertext;
+    std::span<const unsigned char> tag;
+};
+
+inline GcmPackedView gcm_packed_view(std::span<const unsigned char> packed) {
+    throwIf(packed.size() < kGcmPackedOverhead, "Packed message shorter than nonce + tag");
+    const std::size_t n = packed.size() - kGcmPackedOverhead;
+    return {packed.first(kGcmNonceBytes), packed.subspan(kGcmNonceBytes, n), packed.last(kGcmTagBytes)};
+}
+
+// In-place use means `in` sits exactly at `out + offset`; any other overlap
+// would let EVP read bytes it has already overwritten.
+inline void throwIfBadOverlap(std::span<const unsigned char> in, std::span<const unsigned char> out,
+                              std::size_t offset) {
+    auto a = reinterpret_cast<std::uintptr_t>(in.data());
+    auto b = reinterpret_cast<std::uintptr_t>(out.data());
+    bool overlap = !in.empty() && !out.empty() && a < b + out.size() && b < a + in.size();
+    throwIf(overlap && a != b + offset, "Input overlaps output at the wrong offset");
+}
+
+// One record of a batch call. aad may be empty.
+struct GcmSealRecord {
+    std::span<const unsigned char> plaintext;
+    std::span<const unsigned char> aad;
+};
+
+struct GcmOpenRecord {
+    std::span<const unsigned char> packed;  // nonce || ciphertext || tag
+    std::span<const unsigned char> aad;
+    std::span<unsigned char> out;           // >= packed.size() - kGcmPackedOverhead
+};
+
+inline std::size_t gcm_batch_sealed_size(std::span<const GcmSealRecord> records) {
+    std::size_t total = 0;
+    for (const auto& r : records) total += r.plaintext.size() + kGcmPackedOverhead;
+    return total;
+}
+
+// =======================================================
+// GcmSession: key loaded once, only the nonce changes per message
+//   aes256_gcm_encrypt() pays for EVP_CIPHER_CTX_new + two Init calls +
+//   SET_IVLEN + free on every message. For 64-512 byte records that setup
+//   costs more than the AES work, so a session keeps one encrypt and one
+//   decrypt context with the key schedule already expanded.
+//   Not thread-safe: use one session per thread (see gcm_session_cache()).
+// =======================================================
+class GcmSession {
+public:
+    // Pass a shared GcmKeyUsage to enforce the per-key message limit across
+    // threads (gcm_session_cache() does this per key ID).
+    explicit GcmSession(std::span<const unsigned char> key,
+                        std::shared_ptr<GcmKeyUsage> usage = nullptr)
+        : nonces_(std::move(usage)) {
+        throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+
+        enc_.reset(EVP_CIPHER_CTX_new());
+        dec_.reset(EVP_CIPHER_CTX_new());
+        throwIf(!enc_ || !dec_, "EVP_CIPHER_CTX_new failed");
+
+        throwIf(EVP_EncryptInit_ex(enc_.get(), EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1,
+                "EncryptInit (cipher) failed");
+        throwIf(EVP_CIPHER_CTX_ctrl(enc_.get(), EVP_CTRL_GCM_SET_IVLEN, 12, nullptr) != 1,
+                "SET_IVLEN failed");
+        throwIf(EVP_EncryptInit_ex(enc_.get(), nullptr, nullptr, key.data(), nullptr) != 1,
+                "EncryptInit (key) failed");
+
+        throwIf(EVP_DecryptInit_ex(dec_.get(), EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1,
+                "DecryptInit (cipher) failed");
+        throwIf(EVP_CIPHER_CTX_ctrl(dec_.get(), EVP_CTRL_GCM_SET_IVLEN, 12, nullptr) != 1,
+                "SET_IVLEN failed");
+        throwIf(EVP_DecryptInit_ex(dec_.get(), nullptr, nullptr, key.data(), nullptr) != 1,
+                "DecryptInit (key) failed");
+    }
+
+    // Caller-supplied nonce and buffers (ct.size() >= pt.size(), tag 16 bytes).
+    void encrypt(std::span<const unsigned char> nonce,
+                 std::span<const unsigned char> pt,
+                 std::span<unsigned char> ct,
+                 std::span<unsigned char> tag,
+                 std::span<const unsigned char> aad = {}) {
+        throwIf(nonce.size() != 12, "Nonce should be 12 bytes for AES-GCM");
+        throwIf(tag.size() != 16, "Tag must be 16 bytes (recommended) for AES-GCM");
+        throwIf(ct.size() < pt.size(), "Output span smaller than input span");
+        throwIf(pt.size() > kEvpMaxChunk, "Message too large for a single call; use GcmStreamEncryptor");
+
+        EVP_CIPHER_CTX* ctx = enc_.get();
+        throwIf(EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, nonce.data()) != 1,
+                "EncryptInit (iv) failed");
+
+        int len = 0;
+        if (!aad.empty()) {
+            throwIf(EVP_EncryptUpdate(ctx, nullptr, &len, aad.data(), (int)aad.size()) != 1,
+                    "EncryptUpdate (AAD) failed");
+        }
+        int ct_len = 0;
+        if (!pt.empty()) {
+            throwIf(EVP_EncryptUpdate(ctx, ct.data(), &len, pt.data(), (int)pt.size()) != 1,
+                    "EncryptUpdate (pt) failed");
+            ct_len = len;
+        }
+        throwIf(EVP_EncryptFinal_ex(ctx, ct.data() + ct_len, &len) != 1, "EncryptFinal failed");
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, (int)tag.size(), tag.data()) != 1,
+                "GET_TAG failed");
+    }
+
+    // Throws on tag mismatch; pt is then left with unverified data.
+    void decrypt(std::span<const unsigned char> nonce,
+                 std::span<const unsigned char> ct,
+                 std::span<const unsigned char> tag,
+                 std::span<unsigned char> pt,
+                 std::span<const unsigned char> aad = {}) {
+        throwIf(nonce.size() != 12, "Nonce should be 12 bytes for AES-GCM");
+        throwIf(tag.size() != 16, "Tag must be 16 bytes (recommended) for AES-GCM");
+        throwIf(pt.size() < ct.size(), "Output span smaller than input span");
+        throwIf(ct.size() > kEvpMaxChunk, "Message too large for a single call; use GcmStreamDecryptor");
+
+        EVP_CIPHER_CTX* ctx = dec_.get();
+        throwIf(EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, nonce.data()) != 1,
+                "DecryptInit (iv) failed");
+
+        int len = 0;
+        if (!aad.empty()) {
+            throwIf(EVP_DecryptUpdate(ctx, nullptr, &len, aad.data(), (int)aad.size()) != 1,
+                    "DecryptUpdate (AAD) failed");
+        }
+        int pt_len = 0;
+        if (!ct.empty()) {
+            throwIf(EVP_DecryptUpdate(ctx, pt.data(), &len, ct.data(), (int)ct.size()) != 1,
+                    "DecryptUpdate (ct) failed");
+            pt_len = len;
+        }
+        throwIf(EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, (int)tag.size(),
+                                    const_cast<unsigned char*>(tag.data())) != 1,
+                "SET_TAG failed");
+        int ok = EVP_DecryptFinal_ex(ctx, pt.data() + pt_len, &len);
+        throwIf(ok != 1, "DecryptFinal failed: tag mismatch (tampered or wrong key/nonce/tag)");
+    }
+
+    // Writes nonce || ciphertext || tag into `out` and returns the bytes used
+    // (pt.size() + kGcmPackedOverhead). No heap allocation. For in-place
+    // encryption put the plaintext at out.data() + kGcmNonceBytes.
+    std::size_t seal(std::span<const unsigned char> pt,
+                     std::span<unsigned char> out,
+                     std::span<const unsigned char> aad = {}) {
+        return seal(nonces_, pt, out, aad);
+    }
+
+    // seal() with nonces from `nonces` instead of the session's own sequence
+    // (the per-call aes256_gcm_seal passes its thread's sequence).
+    std::size_t seal(GcmNonceSequence& nonces,
+                     std::span<const unsigned char> pt,
+                     std::span<unsigned char> out,
+                     std::span<const unsigned char> aad = {}) {
+        throwIf(out.size() < pt.size() + kGcmPackedOverhead, "Output span too small for packed message");
+        throwIfBadOverlap(pt, out, kGcmNonceBytes);
+
+        auto nonce = out.first(kGcmNonceBytes);
+        nonces.next(nonce);
+        encrypt(nonce, pt, out.subspan(kGcmNonceBytes, pt.size()),
+                out.subspan(kGcmNonceBytes + pt.size(), kGcmTagBytes), aad);
+        return pt.size() + kGcmPackedOverhead;
+    }
+
+    // Reads nonce || ciphertext || tag, writes the plaintext into `out` and
+    // returns its length. In-place: pass out = packed.subspan(kGcmNonceBytes).
+    std::size_t open(std::span<const unsigned char> packed,
+                     std::span<unsigned char> out,
+                     std::span<const unsigned char> aad = {}) {
+        auto view = gcm_packed_view(packed);
+        throwIfBadOverlap(view.ciphertext, out, 0);
+        decrypt(view.nonce, view.ciphertext, view.tag, out, aad);
+        return view.ciphertext.size();
+    }
+
+    // Seals every record back to back into `arena` (see gcm_batch_sealed_size)
+    // with one context and no per-record setup. offsets must hold
+    // records.size() + 1 entries: record i is arena[offsets[i], offsets[i+1]).
+    // Returns the number of arena bytes used.
+    std::size_t seal_batch(std::span<const GcmSealRecord> records,
+                           std::span<unsigned char> arena,
+                           std::span<std::size_t> offsets) {
+        throwIf(offsets.size() < records.size() + 1, "offsets needs records.size() + 1 entries");
+        throwIf(arena.size() < gcm_batch_sealed_size(records), "Arena too small for batch");
+
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const auto& r = records[i];
+            auto out = arena.subspan(pos, r.plaintext.size() + kGcmPackedOverhead);
+            throwIfBadOverlap(r.plaintext, out, kGcmNonceBytes);
+
+            nonces_.next(out.first(kGcmNonceBytes));
+            encrypt(out.first(kGcmNonceBytes), r.plaintext, out.subspan(kGcmNonceBytes, r.plaintext.size()),
+                    out.last(kGcmTagBytes), r.aad);
+
+            offsets[i] = pos;
+            pos += out.size();
+        }
+        offsets[records.size()] = pos;
+        return pos;
+    }
+
+    // Opens every record with one context. A record that fails verification
+    // does not stop the batch: its `out` is zeroed and ok[i] is set to false.
+    // Returns the number of records that failed.
+    std::size_t open_batch(std::span<const GcmOpenRecord> records, std::span<bool> ok) {
+        throwIf(ok.size() < records.size(), "ok needs one entry per record");
+
+        std::size_t failed = 0;
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const auto& r = records[i];
+            try {
+                open(r.packed, r.out, r.aad);
+                ok[i] = true;
+            } catch (const std::runtime_error&) {
+                std::size_t n = std::min(r.out.size(), r.packed.size() - std::min(r.packed.size(), kGcmPackedOverhead));
+                std::memset(r.out.data(), 0, n);
+                ok[i] = false;
+                failed++;
+            }
+        }
+        return failed;
+    }
+
+    // Same shape as aes256_gcm_encrypt / aes256_gcm_decrypt.
+    GcmEncrypted encrypt(const std::vector<unsigned char>& plaintext,
+                         const std::vector<unsigned char>& aad = {}) {
+        GcmEncrypted out;
+        out.nonce.resize(12);
+        out.tag.resize(16);
+        out.ciphertext.resize(plaintext.size());
+        nonces_.next(out.nonce);
+
+        encrypt(out.nonce, plaintext, out.ciphertext, out.tag, aad);
+        return out;
+    }
+
+    std::vector<unsigned char> decrypt(const std::vector<unsigned char>& nonce,
+                                       const std::vector<unsigned char>& ciphertext,
+                                       const std::vector<unsigned char>& tag,
+                                       const std::vector<unsigned char>& aad = {}) {
+        std::vector<unsigned char> plaintext(ciphertext.size());
+        decrypt(nonce, ciphertext, tag, plaintext, aad);
+        return plaintext;
+    }
+
+    // True once this key is close to its message limit; rotate it soon.
+    bool needs_rekey() const noexcept { return nonces_.needs_rekey(); }
+
+private:
+    CipherCtxPtr enc_;
+    CipherCtxPtr dec_;
+    GcmNonceSequence nonces_;
+};
+
+// Per-thread GcmSession cache keyed by key ID.
+//   auto s = gcm_session_cache().get("orders-v3", key);
+// The key bytes are only read the first time an ID is seen on a thread;
+// after rotating the key behind an ID call gcm_key_usage_reset(id) once and
+// forget(id) on each thread (or check s->needs_rekey() first).
+// Sessions are shared: one evicted or forgotten while a caller still holds
+// it stays alive until that caller lets go.
+class GcmSessionCache {
+public:
+    static constexpr std::size_t kMaxSessions = 64;
+
+    std::shared_ptr<GcmSession> get(const std::string& key_id, std::span<const unsigned char> key) {
+        auto it = sessions_.find(key_id);
+        if (it != sessions_.end()) {
+            it->second.last_use = ++tick_;
+            return it->second.session;
+        }
+
+        // Bounded: a thread touching many keys drops the least recently used.
+        if (sessions_.size() >= kMaxSessions) {
+            auto lru = std::min_element(sessions_.begin(), sessions_.end(), [](const auto& a, const auto& b) {
+                return a.second.last_use < b.second.last_use;
+            });
+            sessions_.erase(lru);
+        }
+        auto session = std::make_shared<GcmSession>(key, gcm_key_usage(key_id));
+        sessions_.emplace(key_id, Entry{session, ++tick_});
+        return session;
+    }
+
+    void forget(const std::string& key_id) { sessions_.erase(key_id); }
+    void clear() { sessions_.clear(); }
+    std::size_t size() const noexcept { return sessions_.size(); }
+
+private:
+    struct Entry {
+        std::shared_ptr<GcmSession> session;
+        std::uint64_t last_use;
+    };
+
+    std::unordered_map<std::string, Entry> sessions_;
+    std::uint64_t tick_ = 0;
+};
+
+inline GcmSessionCache& gcm_session_cache() {
+    thread_local GcmSessionCache cache;
+    return cache;
+}
+
+// =======================================================
+// Parallel segmented AES-256-GCM (STREAM construction)
+//   The plaintext is cut into fixed-size segments, each sealed on its own
+//   with nonce = 0(7) || segment index (4, big-endian) || last flag (1).
+//   Swapping segments changes their nonce and dropping the tail leaves a
+//   segment without the last flag, so both fail authentication.
+//
+//   Segments are not sealed under the caller's key but under a per-stream
+//   subkey, HKDF-SHA256(key, salt from the header). Nonces then only have
+//   to be unique within one stream; a random nonce prefix under the long-
+//   lived key would collide (birthday) after about 2^28 streams.
+//
+//   Wire format:
+//     header  : salt(16) || segment_size(4, big-endian)
+//     segment : ciphertext(segment_size, or less for the last) || tag(16)
+//   The header and the caller's AAD are authenticated by every segment.
+// =======================================================
+
+constexpr std::size_t kStreamSaltBytes = 16;
+constexpr std::size_t kStreamHeaderBytes = kStreamSaltBytes + 4;
+constexpr std::size_t kStreamDefaultSegment = 1024 * 1024;
+
+inline std::array<unsigned char, 12> stream_segment_nonce(std::uint32_t index, bool last) {
+    std::array<unsigned char, 12> nonce{};
+    nonce[7] = static_cast<unsigned char>(index >> 24);
+    nonce[8] = static_cast<unsigned char>(index >> 16);
+    nonce[9] = static_cast<unsigned char>(index >> 8);
+    nonce[10] = static_cast<unsigned char>(index);
+    nonce[11] = last ? 1 : 0;
+    return nonce;
+}
+
+// Per-stream subkey from the caller's key and the header's salt. Wipes
+// itself on destruction.
+class StreamKey {
+public:
+    StreamKey(std::span<const unsigned char> key, std::span<const unsigned char> header) {
+        throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+        throwIf(header.size() < kStreamHeaderBytes, "Stream header too short");
+        static constexpr char kInfo[] = "xlab aes-256-gcm stream v1";
+
+        std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr),
+                                                                      EVP_PKEY_CTX_free);
+        std::size_t len = key_.size();
+        throwIf(!ctx || EVP_PKEY_derive_init(ctx.get()) != 1 ||
+                    EVP_PKEY_CTX_set_hkdf_md(ctx.get(), EVP_sha256()) != 1 ||
+                    EVP_PKEY_CTX_set1_hkdf_salt(ctx.get(), header.data(), (int)kStreamSaltBytes) != 1 ||
+                    EVP_PKEY_CTX_set1_hkdf_key(ctx.get(), key.data(), (int)key.size()) != 1 ||
+                    EVP_PKEY_CTX_add1_hkdf_info(ctx.get(), reinterpret_cast<const unsigned char*>(kInfo),
+                                                (int)(sizeof kInfo - 1)) != 1 ||
+                    EVP_PKEY_derive(ctx.get(), key_.data(), &len) != 1 || len != key_.size(),
+                "HKDF (stream subkey) failed");
+    }
+    ~StreamKey() { OPENSSL_cleanse(key_.data(), key_.size()); }
+
+    StreamKey(const StreamKey&) = delete;
+    StreamKey& operator=(const StreamKey&) = delete;
+
+    std::span<const unsigned char> bytes() const noexcept { return key_; }
+
+private:
+    std::array<unsigned char, 32> key_{};
+};
+
+// header || caller AAD: the AAD of every segment. Its first 16 bytes are the salt.
+inline std::vector<unsigned char> stream_make_header(std::size_t segment_size,
+                                                     std::span<const unsigned char> aad = {}) {
+    throwIf(segment_size == 0 || segment_size > kEvpMaxChunk, "Segment size must be in (0, 2^31)");
+
+    std::vector<unsigned char> header(kStreamHeaderBytes);
+    throwIf(RAND_bytes(header.data(), (int)kStreamSaltBytes) != 1, "RAND_bytes failed");
+    header[16] = static_cast<unsigned char>(segment_size >> 24);
+    header[17] = static_cast<unsigned char>(segment_size >> 16);
+    header[18] = static_cast<unsigned char>(segment_size >> 8);
+    header[19] = static_cast<unsigned char>(segment_size);
+    header.insert(header.end(), aad.begin(), aad.end());
+    return header;
+}
+
+inline std::size_t stream_header_segment_size(std::span<const unsigned char> header) {
+    throwIf(header.size() < kStreamHeaderBytes, "Stream header too short");
+    std::size_t segment_size = (std::size_t{header[16]} << 24) | (std::size_t{header[17]} << 16) |
+                               (std::size_t{header[18]} << 8) | std::size_t{header[19]};
+    throwIf(segment_size == 0 || segment_size > kEvpMaxChunk, "Invalid segment size in header");
+    return segment_size;
+}
+
+struct StreamLayout {
+    std::size_t segment_size;
+    std::size_t segments;
+    std::size_t last_plain;  // plaintext bytes in the final segment
+};
+
+inline StreamLayout stream_layout_for_plaintext(std::size_t plaintext_size, std::size_t segment_size) {
+    std::size_t segments = std::max<std::size_t>(1, (plaintext_size + segment_size - 1) / segment_size);
+    throwIf(segments > UINT32_MAX, "Too many segments; use a larger segment size");
+    return {segment_size, segments, plaintext_size - (segments - 1) * segment_size};
+}
+
+// body_size = sealed size minus the header.
+inline StreamLayout stream_layout_for_sealed(std::size_t body_size, std::size_t segment_size) {
+    throwIf(body_size < 16, "Sealed message too short");
+    const std::size_t stride = segment_size + 16;
+    const std::size_t segments = (body_size + stride - 1) / stride;
+    const std::size_t last_ct = body_size - (segments - 1) * stride;
+    throwIf(last_ct < 16 || (last_ct == 16 && segments > 1), "Sealed message has a malformed final segment");
+    throwIf(segments > UINT32_MAX, "Too many segments");
+    return {segment_size, segments, last_ct - 16};
+}
+
+// out = ciphertext(pt.size()) || tag(16)
+inline void stream_seal_segment(GcmSession& session, std::span<const unsigned char> header_aad,
+                                std::size_t index, bool last,
+                                std::span<const unsigned char> pt, std::span<unsigned char> out) {
+    auto nonce = stream_segment_nonce(static_cast<std::uint32_t>(index), last);
+    session.encrypt(nonce, pt, out.first(pt.size()), out.subspan(pt.size(), 16), header_aad);
+}
+
+// sealed = ciphertext || tag(16); throws if the segment does not verify.
+inline void stream_open_segment(GcmSession& session, std::span<const unsigned char> header_aad,
+                                std::size_t index, bool last,
+                                std::span<const unsigned char> sealed, std::span<unsigned char> out) {
+    throwIf(sealed.size() < 16, "Sealed segment too short");
+    const std::size_t n = sealed.size() - 16;
+    auto nonce = stream_segment_nonce(static_cast<std::uint32_t>(index), last);
+    session.decrypt(nonce, sealed.first(n), sealed.last(16), out.first(n), header_aad);
+}
+
+// Runs job(i) for i in [0, count) on `threads` workers (dynamic scheduling).
+// Each worker gets its own GcmSession; the first exception is rethrown.
+template <typename Job>
+void run_segment_workers(std::span<const unsigned char> key, std::size_t count,
+                         unsigned threads, Job job) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, count));
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::atomic_flag error_set = ATOMIC_FLAG_INIT;
+
+    auto worker = [&]() {
+        try {
+            GcmSession session(key);
+            for (std::size_t i = next.fetch_add(1); i < count && !failed.load(std::memory_order_relaxed);
+                 i = next.fetch_add(1)) {
+                job(session, i);
+            }
+        } catch (...) {
+            if (!error_set.test_and_set()) error = std::current_exception();
+            failed.store(true);
+        }
+    };
+
+    if (threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker);
+        for (auto& t : pool) t.join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+inline std::size_t stream_sealed_size(std::size_t plaintext_size, std::size_t segment_size) {
+    auto layout = stream_layout_for_plaintext(plaintext_size, segment_size);
+    return kStreamHeaderBytes + plaintext_size + layout.segments * 16;
+}
+
+// threads = 0 means std::thread::hardware_concurrency().
+inline std::vector<unsigned char> aes256_gcm_encrypt_parallel(std::span<const unsigned char> key,
+                                                             std::span<const unsigned char> plaintext,
+                                                             std::span<const unsigned char> aad = {},
+                                                             std::size_t segment_size = kStreamDefaultSegment,
+                                                             unsigned threads = 0) {
+    throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+    const auto header_aad = stream_make_header(segment_size, aad);
+    const auto layout = stream_layout_for_plaintext(plaintext.size(), segment_size);
+
+    std::vector<unsigned char> sealed(stream_sealed_size(plaintext.size(), segment_size));
+    std::memcpy(sealed.data(), header_aad.data(), kStreamHeaderBytes);
+
+    const StreamKey stream_key(key, header_aad);
+    run_segment_workers(stream_key.bytes(), layout.segments, threads, [&](GcmSession& session, std::size_t i) {
+        const bool last = i + 1 == layout.segments;
+        const std::size_t n = last ? layout.last_plain : segment_size;
+        auto dst = std::span(sealed).subspan(kStreamHeaderBytes + i * (segment_size + 16), n + 16);
+        stream_seal_segment(session, header_aad, i, last, plaintext.subspan(i * segment_size, n), dst);
+    });
+    return sealed;
+}
+
+// Throws (and wipes the output) if any segment fails, was reordered or the
+// message was truncated.
+inline std::vector<unsigned char> aes256_gcm_decrypt_parallel(std::span<const unsigned char> key,
+                                                             std::span<const unsigned char> sealed,
+                                                             std::span<const unsigned char> aad = {},
+                                                             unsigned threads = 0) {
+    throwIf(key.size() != 32, "Key must be 32 bytes for AES-256");
+    const std::size_t segment_size = stream_header_segment_size(sealed);
+    const auto layout = stream_layout_for_sealed(sealed.size() - kStreamHeaderBytes, segment_size);
+
+    std::vector<unsigned char> plaintext((layout.segments - 1) * segment_size + layout.last_plain);
+
+    std::vector<unsigned char> header_aad(sealed.begin(), sealed.begin() + kStreamHeaderBytes);
+    header_aad.insert(header_aad.end(), aad.begin(), aad.end());
+
+    const StreamKey stream_key(key, header_aad);
+    try {
+        run_segment_workers(stream_key.bytes(), layout.segments, threads, [&](GcmSession& session, std::size_t i) {
+            const bool last = i + 1 == layout.segments;
+            const std::size_t n = last ? layout.last_plain : segment_size;
+            auto src = sealed.subspan(kStreamHeaderBytes + i * (segment_size + 16), n + 16);
+            stream_open_segment(session, header_aad, i, last, src, std::span(plaintext).subspan(i * segment_size, n));
+        });
+    } catch (...) {
+        std::fill(plaintext.begin(), plaintext.end(), 0);
+        throw;
+    }
+    return plaintext;
+}
+
+// Span overloads of aes256_gcm_encrypt / aes256_gcm_decrypt using the packed
+// nonce || ciphertext || tag format. They still build a context per call;
+// the allocation-free hot path is GcmSession::seal / GcmSession::open.
+// Nonces come from the thread's sequence (key_id as in aes256_gcm_encrypt),
+// not from the throwaway session.
+inline std::size_t aes256_gcm_seal(std::span<const unsigned char> key,
+                                   std::span<const unsigned char> plaintext,
+                                   std::span<unsigned char> out,
+                                   std::span<const unsigned char> aad = {},
+                                   const std::string& key_id = {}) {
+    return GcmSession(key).seal(thread_nonce_sequence(key_id), plaintext, out, aad);
+}
+
+inline std::size_t aes256_gcm_open(std::span<const unsigned char> key,
+                                   std::span<const unsigned char> packed,
+                                   std::span<unsigned char> out,
+                                   std::span<const unsigned char> aad = {}) {
+    return GcmSession(key).open(packed, out, aad);
+}
@@ -0,0 +1,120 @@
+#include "AES.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// =======================================================
+// Allocation check for the span / packed AEAD hot path
+//   Counts every operator new and every OpenSSL allocation
+//   (CRYPTO_set_mem_functions) while GcmSession::seal/open run.
+//   Exits non-zero if the hot path allocated anything.
+//
+// Build/run (example):
+//   g++ -std=c++20 -O2 -Wall AESAllocCheck.cpp -lcrypto && ./a.out
+// =======================================================
+
+static std::atomic<std::size_t> g_new_calls{0};
+static std::atomic<std::size_t> g_crypto_calls{0};
+
+void* operator new(std::size_t n) {
+    g_new_calls.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static void* count_malloc(std::size_t n, const char*, int) {
+    g_crypto_calls.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(n);
+}
+static void* count_realloc(void* p, std::size_t n, const char*, int) {
+    g_crypto_calls.fetch_add(1, std::memory_order_relaxed);
+    return std::realloc(p, n);
+}
+static void count_free(void* p, const char*, int) { std::free(p); }
+
+struct AllocCount {
+    std::size_t cxx;
+    std::size_t crypto;
+};
+
+static AllocCount alloc_now() {
+    return {g_new_calls.load(), g_crypto_calls.load()};
+}
+
+int main() {
+    // Must run before OpenSSL allocates anything.
+    if (CRYPTO_set_mem_functions(count_malloc, count_realloc, count_free) != 1) {
+        std::cerr << "CRYPTO_set_mem_functions failed (called too late?)\n";
+        return 1;
+    }
+
+    unsigned char key[32];
+    throwIf(RAND_bytes(key, sizeof key) != 1, "RAND_bytes failed");
+    const unsigned char aad[] = {'h', 'd', 'r'};
+
+    // Setup may allocate: the context, the key schedule, the per-thread DRBG.
+    GcmSession session(key);
+    static unsigned char pt[65536];
+    static unsigned char wire[sizeof pt + kGcmPackedOverhead];
+    static unsigned char back[sizeof pt];
+    session.open(std::span(wire, session.seal(std::span(pt, 16), wire, aad)), back, aad);
+
+    bool ok = true;
+    for (std::size_t size : {0, 64, 1500, 65536}) {
+        auto before = alloc_now();
+
+        for (int i = 0; i < 1000; ++i) {
+            // Separate buffers
+            std::size_t n = session.seal(std::span(pt, size), wire, aad);
+            session.open(std::span(wire, n), back, aad);
+
+            // In place: plaintext already sits where the ciphertext goes
+            std::memcpy(wire + kGcmNonceBytes, pt, size);
+            n = session.seal(std::span(wire + kGcmNonceBytes, size), wire, aad);
+            session.open(std::span(wire, n), std::span(wire + kGcmNonceBytes, size), aad);
+            throwIf(std::memcmp(wire + kGcmNonceBytes, pt, size) != 0, "in-place round trip mismatch");
+        }
+
+        auto after = alloc_now();
+        std::size_t cxx = after.cxx - before.cxx;
+        std::size_t crypto = after.crypto - before.crypto;
+        ok = ok && cxx == 0 && crypto == 0;
+
+        std::cout << "size=" << size << "  operator new: " << cxx
+                  << "  OpenSSL allocs: " << crypto
+                  << (cxx == 0 && crypto == 0 ? "  OK" : "  FAIL") << "\n";
+    }
+
+    // Batch: 256 records of 64 B into one arena
+    {
+        static GcmSealRecord records[256];
+        static std::size_t offsets[257];
+        static unsigned char arena[256 * (64 + kGcmPackedOverhead)];
+        for (std::size_t i = 0; i < 256; ++i) records[i] = {std::span(pt + i * 64, 64), std::span(aad)};
+        session.seal_batch(records, arena, offsets);
+
+        auto before = alloc_now();
+        for (int i = 0; i < 100; ++i) session.seal_batch(records, arena, offsets);
+        auto after = alloc_now();
+        bool batch_ok = after.cxx == before.cxx && after.crypto == before.crypto;
+        ok = ok && batch_ok;
+        std::cout << "seal_batch x256  operator new: " << after.cxx - before.cxx
+                  << "  OpenSSL allocs: " << after.crypto - before.crypto
+                  << (batch_ok ? "  OK" : "  FAIL") << "\n";
+    }
+
+    // Reference: the per-call span overload builds a context every time, so
+    // the counters must see it (this also proves the hooks are live).
+    auto before = alloc_now();
+    aes256_gcm_seal(key, std::span(pt, 64), wire, aad);
+    auto after = alloc_now();
+    std::cout << "per-call aes256_gcm_seal (reference)  operator new: " << after.cxx - before.cxx
+              << "  OpenSSL allocs: " << after.crypto - before.crypto << "\n";
+    ok = ok && after.crypto > before.crypto;
+
+    std::cout << (ok ? "PASS: seal/open/seal_batch allocate nothing\n" : "FAIL: hot path allocated\n");
+    return ok ? 0 : 1;
+}
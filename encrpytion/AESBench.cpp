@@ -0,0 +1,761 @@
+#include "AES.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <chrono>
+#include <cstdio>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* Usage
+./aes_bench stream                      # 1MB .. 50GB through a 1MB buffer
+./aes_bench stream 4MB 1MB 1GB 50GB     # chunk=4MB, then the input sizes
+./aes_bench session                     # 64..512 B messages, per-call vs GcmSession
+./aes_bench session 500000 64 1024      # message count, then message sizes
+./aes_bench parallel                    # 1GB blob, 1MB segments, 1..all threads
+./aes_bench parallel 4GB 4MB 1 8 16     # size, segment size, then thread counts
+./aes_bench batch                       # 128 B rows + 8 B AAD, batch 1/16/256/4096
+./aes_bench batch 1000000 256 1 4096    # total records, record size, then batch sizes
+./aes_bench nonce                       # RAND_bytes vs GcmNonceSequence, 1..all threads
+./aes_bench nonce 2000000 1 8 32        # messages per thread, then thread counts
+./aes_bench sweep                       # 16B..1GB, C++ vs AES.py -> aes_bench.json
+./aes_bench sweep 64MB out.json none    # max size, JSON path, AESBench.py path (or none)
+*/
+
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall AESBench.cpp -lcrypto -o aes_bench
+
+using Clock = std::chrono::steady_clock;
+
+// Parse strings like: "50GB", "512MB", "4096KB", "100B"
+static std::size_t parse_size(std::string s) {
+    for (char& c : s) c = std::toupper(static_cast<unsigned char>(c));
+
+    std::size_t i = 0;
+    while (i < s.size() && (std::isdigit(static_cast<unsigned char>(s[i])) || s[i] == '.')) i++;
+    if (i == 0) throw std::runtime_error("Size must start with a number (e.g., 64MB)");
+
+    double value = std::stod(s.substr(0, i));
+    std::string unit = s.substr(i);
+
+    std::size_t mult = 1;
+    if (unit.empty() || unit == "B") mult = 1;
+    else if (unit == "KB") mult = 1024ULL;
+    else if (unit == "MB") mult = 1024ULL * 1024;
+    else if (unit == "GB") mult = 1024ULL * 1024 * 1024;
+    else throw std::runtime_error("Unknown unit. Use B/KB/MB/GB (e.g., 64MB)");
+
+    return static_cast<std::size_t>(value * static_cast<double>(mult));
+}
+
+static std::string format_size(std::size_t bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB"};
+    int u = 0;
+    double v = static_cast<double>(bytes);
+    while (v >= 1024.0 && u < 3) { v /= 1024.0; u++; }
+    std::ostringstream os;
+    os << v << units[u];
+    return os.str();
+}
+
+// Reads "VmRSS:" / "VmHWM:" from /proc/self/status (kB). Returns 0 if unavailable.
+static std::size_t proc_status_kb(const std::string& field) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind(field, 0) == 0) return std::stoull(line.substr(field.size()));
+    }
+    return 0;
+}
+
+// Keeps the compiler from discarding a result we only compute for timing.
+template <typename T>
+static void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// RAND_bytes takes an int length, so multi-GB buffers are filled in chunks.
+static std::vector<unsigned char> random_bytes(std::size_t n) {
+    std::vector<unsigned char> v(n);
+    for (std::size_t off = 0; off < n;) {
+        const std::size_t chunk = std::min<std::size_t>(n - off, INT_MAX);
+        throwIf(RAND_bytes(v.data() + off, (int)chunk) != 1, "RAND_bytes failed");
+        off += chunk;
+    }
+    return v;
+}
+
+// =======================================================
+// CASE 1: stream
+//   Encrypts N bytes through one fixed-size buffer, then decrypts them
+//   again. Peak RSS must stay flat no matter how large N gets.
+// =======================================================
+static void bench_stream(std::size_t chunk, const std::vector<std::size_t>& sizes) {
+    auto key = random_bytes(32);
+    auto nonce = random_bytes(12);
+
+    // The only data buffers: one input chunk, one output chunk.
+    auto in = random_bytes(chunk);
+    std::vector<unsigned char> out(chunk);
+
+    std::cout << "chunk=" << format_size(chunk) << "\n";
+    std::cout << std::left << std::setw(10) << "size"
+              << std::right << std::setw(12) << "enc GB/s"
+              << std::setw(12) << "dec GB/s"
+              << std::setw(14) << "VmRSS(MB)"
+              << std::setw(14) << "VmHWM(MB)" << "\n";
+
+    GcmStreamEncryptor enc;
+    GcmStreamDecryptor dec;
+
+    for (std::size_t total : sizes) {
+        auto t0 = Clock::now();
+        enc.init(key, nonce);
+        for (std::size_t done = 0; done < total; done += chunk) {
+            std::size_t n = std::min(chunk, total - done);
+            enc.update(std::span(in).first(n), out);
+        }
+        enc.finalize();
+        double enc_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        // Decrypt side: treat the same `in` chunk, repeated, as ciphertext.
+        // Its tag is found with an untimed decrypt->re-encrypt pass (CTR is
+        // symmetric), so the timed pass verifies a real tag without ever
+        // holding N bytes.
+        dec.init(key, nonce);
+        enc.init(key, nonce);
+        for (std::size_t done = 0; done < total; done += chunk) {
+            std::size_t n = std::min(chunk, total - done);
+            dec.update(std::span(in).first(n), out);
+            enc.update(std::span(out).first(n), out);
+        }
+        auto ct_tag = enc.finalize();
+
+        t0 = Clock::now();
+        dec.init(key, nonce);
+        for (std::size_t done = 0; done < total; done += chunk) {
+            std::size_t n = std::min(chunk, total - done);
+            dec.update(std::span(in).first(n), out);
+        }
+        dec.finalize(ct_tag);
+        double dec_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        const double gb = static_cast<double>(total) / 1e9;
+        std::cout << std::left << std::setw(10) << format_size(total)
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << gb / enc_s
+                  << std::setw(12) << gb / dec_s
+                  << std::setw(14) << proc_status_kb("VmRSS:") / 1024.0
+                  << std::setw(14) << proc_status_kb("VmHWM:") / 1024.0 << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
+
+// =======================================================
+// CASE 2: session
+//   Small messages: per-call aes256_gcm_encrypt (new context + key setup
+//   every time) vs a GcmSession that only resets the nonce.
+// =======================================================
+static void bench_session(std::size_t count, const std::vector<std::size_t>& sizes) {
+    auto key = random_bytes(32);
+
+    // Sanity: both paths must interoperate before we time anything.
+    {
+        auto pt = random_bytes(100);
+        GcmSession s(key);
+        auto a = aes256_gcm_encrypt(key, pt);
+        auto b = s.encrypt(pt);
+        throwIf(s.decrypt(a.nonce, a.ciphertext, a.tag) != pt, "session decrypt mismatch");
+        throwIf(aes256_gcm_decrypt(key, b.nonce, b.ciphertext, b.tag) != pt, "per-call decrypt mismatch");
+    }
+
+    std::cout << "messages=" << count << "\n";
+    std::cout << std::left << std::setw(8) << "size"
+              << std::right << std::setw(16) << "per-call msg/s"
+              << std::setw(16) << "session msg/s"
+              << std::setw(16) << "span msg/s"
+              << std::setw(10) << "speedup" << "\n";
+
+    for (std::size_t size : sizes) {
+        auto pt = random_bytes(size);
+
+        auto t0 = Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            auto enc = aes256_gcm_encrypt(key, pt);
+            keep(enc);
+        }
+        double per_call_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        // Cache lookup is part of the measured path, as it would be in a server.
+        t0 = Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            auto enc = gcm_session_cache().get("bench", key)->encrypt(pt);
+            keep(enc);
+        }
+        double session_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        // Same session, caller-owned packed buffer (no per-message vectors).
+        std::vector<unsigned char> wire(size + kGcmPackedOverhead);
+        auto s = gcm_session_cache().get("bench", key);
+        t0 = Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            s->seal(pt, wire);
+            keep(wire);
+        }
+        double span_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        const double n = static_cast<double>(count);
+        std::cout << std::left << std::setw(8) << size
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(16) << n / per_call_s
+                  << std::setw(16) << n / session_s
+                  << std::setw(16) << n / span_s
+                  << std::setprecision(2) << std::setw(9) << per_call_s / session_s << "x\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
+
+// =======================================================
+// CASE 3: parallel
+//   Throughput vs thread count for the segmented (STREAM) construction.
+// =======================================================
+static void check_stream_tampering(const std::vector<unsigned char>& key) {
+    const std::size_t seg = 4096;
+    auto pt = random_bytes(3 * seg + 100);
+    auto sealed = aes256_gcm_encrypt_parallel(key, pt, {}, seg, 2);
+    throwIf(aes256_gcm_decrypt_parallel(key, sealed) != pt, "parallel round trip mismatch");
+
+    auto expect_fail = [&](std::vector<unsigned char> bad, const char* what) {
+        try {
+            aes256_gcm_decrypt_parallel(key, bad);
+        } catch (const std::runtime_error&) {
+            return;
+        }
+        throw std::runtime_error(what);
+    };
+
+    auto swapped = sealed;  // segments 0 and 1 exchanged
+    std::swap_ranges(swapped.begin() + kStreamHeaderBytes,
+                     swapped.begin() + kStreamHeaderBytes + seg + 16,
+                     swapped.begin() + kStreamHeaderBytes + seg + 16);
+    expect_fail(swapped, "reordered segments were accepted");
+
+    auto truncated = sealed;  // drop the final segment
+    truncated.resize(kStreamHeaderBytes + 3 * (seg + 16));
+    expect_fail(truncated, "truncated message was accepted");
+
+    auto flipped = sealed;
+    flipped.back() ^= 1;
+    expect_fail(flipped, "modified tag was accepted");
+}
+
+static void bench_parallel(std::size_t size, std::size_t segment, std::vector<unsigned> threads) {
+    auto key = random_bytes(32);
+    check_stream_tampering(key);
+
+    auto pt = random_bytes(size);
+    std::cout << "size=" << format_size(size) << " segment=" << format_size(segment)
+              << " hw_threads=" << std::thread::hardware_concurrency() << "\n";
+    std::cout << std::left << std::setw(8) << "threads"
+              << std::right << std::setw(12) << "enc GB/s"
+              << std::setw(12) << "dec GB/s"
+              << std::setw(12) << "speedup"
+              << std::setw(14) << "efficiency" << "\n";
+
+    double base = 0.0;
+    for (unsigned t : threads) {
+        auto t0 = Clock::now();
+        auto sealed = aes256_gcm_encrypt_parallel(key, pt, {}, segment, t);
+        double enc_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        t0 = Clock::now();
+        auto back = aes256_gcm_decrypt_parallel(key, sealed, {}, t);
+        double dec_s = std::chrono::duration<double>(Clock::now() - t0).count();
+        throwIf(back != pt, "parallel round trip mismatch");
+
+        const double gb = static_cast<double>(size) / 1e9;
+        if (base == 0.0) base = enc_s * t;
+        const double speedup = base / enc_s;
+        std::cout << std::left << std::setw(8) << t
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << gb / enc_s
+                  << std::setw(12) << gb / dec_s
+                  << std::setw(11) << speedup << "x"
+                  << std::setw(13) << 100.0 * speedup / t << "%\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
+
+// =======================================================
+// CASE 4: batch
+//   Database-row sized records: one aes256_gcm_encrypt per row vs one
+//   seal_batch call per N rows into a preallocated arena.
+// =======================================================
+static void bench_batch(std::size_t total, std::size_t record, const std::vector<std::size_t>& batches) {
+    auto key = random_bytes(32);
+    GcmSession session(key);
+
+    std::cout << "records=" << total << " record=" << record << "B aad=8B\n";
+    std::cout << std::left << std::setw(8) << "batch"
+              << std::right << std::setw(18) << "per-call rec/s"
+              << std::setw(18) << "batch rec/s"
+              << std::setw(18) << "open rec/s"
+              << std::setw(10) << "speedup" << "\n";
+
+    for (std::size_t batch : batches) {
+        // Rows and row ids (used as AAD) for one batch, reused every round.
+        auto rows = random_bytes(batch * record);
+        std::vector<std::uint64_t> ids(batch);
+        std::vector<GcmSealRecord> records(batch);
+        for (std::size_t i = 0; i < batch; ++i) {
+            ids[i] = i;
+            records[i] = {std::span(rows).subspan(i * record, record),
+                          std::span(reinterpret_cast<const unsigned char*>(&ids[i]), sizeof ids[i])};
+        }
+
+        std::vector<unsigned char> arena(gcm_batch_sealed_size(records));
+        std::vector<std::size_t> offsets(batch + 1);
+        std::vector<unsigned char> plain(batch * record);
+        std::vector<GcmOpenRecord> opens(batch);
+        std::unique_ptr<bool[]> ok(new bool[batch]);
+        const std::size_t rounds = std::max<std::size_t>(1, total / batch);
+
+        auto t0 = Clock::now();
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (std::size_t i = 0; i < batch; ++i) {
+                // The vector API forces a copy of each row and its AAD.
+                std::vector<unsigned char> pt(records[i].plaintext.begin(), records[i].plaintext.end());
+                std::vector<unsigned char> aad(records[i].aad.begin(), records[i].aad.end());
+                auto enc = aes256_gcm_encrypt(key, pt, aad);
+                keep(enc);
+            }
+        }
+        double per_call_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        t0 = Clock::now();
+        for (std::size_t r = 0; r < rounds; ++r) {
+            session.seal_batch(records, arena, offsets);
+            keep(arena);
+        }
+        double batch_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        for (std::size_t i = 0; i < batch; ++i) {
+            opens[i] = {std::span(arena).subspan(offsets[i], offsets[i + 1] - offsets[i]),
+                        records[i].aad, std::span(plain).subspan(i * record, record)};
+        }
+        t0 = Clock::now();
+        for (std::size_t r = 0; r < rounds; ++r) {
+            throwIf(session.open_batch(opens, std::span(ok.get(), batch)) != 0, "batch open failed");
+        }
+        double open_s = std::chrono::duration<double>(Clock::now() - t0).count();
+        throwIf(plain != rows, "batch round trip mismatch");
+
+        const double n = static_cast<double>(rounds * batch);
+        std::cout << std::left << std::setw(8) << batch
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(18) << n / per_call_s
+                  << std::setw(18) << n / batch_s
+                  << std::setw(18) << n / open_s
+                  << std::setprecision(2) << std::setw(9) << per_call_s / batch_s << "x\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
+
+// =======================================================
+// CASE 5: nonce
+//   Every thread encrypts 64 B messages with its own GcmSession; the only
+//   difference is where the nonce comes from: RAND_bytes per message
+//   (shared DRBG) vs the per-thread GcmNonceSequence.
+// =======================================================
+template <typename Work>
+static double run_threads(unsigned threads, Work work) {
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    auto t0 = Clock::now();
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(work);
+    for (auto& t : pool) t.join();
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static void bench_nonce(std::size_t per_thread, const std::vector<unsigned>& threads) {
+    auto key = random_bytes(32);
+    auto usage = std::make_shared<GcmKeyUsage>();
+
+    std::cout << "messages/thread=" << per_thread << " size=64B\n";
+    std::cout << std::left << std::setw(8) << "threads"
+              << std::right << std::setw(16) << "RAND ns/nonce"
+              << std::setw(16) << "seq ns/nonce"
+              << std::setw(16) << "RAND msg/s"
+              << std::setw(16) << "seq msg/s" << "\n";
+
+    for (unsigned t : threads) {
+        const double n = static_cast<double>(per_thread) * t;
+
+        // Nonce generation alone
+        double rand_only = run_threads(t, [&]() {
+            unsigned char nonce[12];
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                throwIf(RAND_bytes(nonce, sizeof nonce) != 1, "RAND_bytes failed");
+                keep(nonce);
+            }
+        });
+        double seq_only = run_threads(t, [&]() {
+            GcmNonceSequence seq(usage);
+            unsigned char nonce[12];
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                seq.next(nonce);
+                keep(nonce);
+            }
+        });
+
+        // Full encrypt path
+        double rand_enc = run_threads(t, [&]() {
+            GcmSession session(key);
+            unsigned char pt[64] = {}, wire[64 + kGcmPackedOverhead];
+            auto w = std::span(wire);
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                throwIf(RAND_bytes(wire, kGcmNonceBytes) != 1, "RAND_bytes failed");
+                session.encrypt(w.first(kGcmNonceBytes), pt, w.subspan(kGcmNonceBytes, 64), w.last(kGcmTagBytes));
+                keep(wire);
+            }
+        });
+        double seq_enc = run_threads(t, [&]() {
+            GcmSession session(key, usage);
+            unsigned char pt[64] = {}, wire[64 + kGcmPackedOverhead];
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                session.seal(pt, wire);
+                keep(wire);
+            }
+        });
+
+        std::cout << std::left << std::setw(8) << t
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(16) << rand_only * 1e9 * t / n
+                  << std::setw(16) << seq_only * 1e9 * t / n
+                  << std::setprecision(0)
+                  << std::setw(16) << n / rand_enc
+                  << std::setw(16) << n / seq_enc << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+    std::cout << "key usage: " << usage->used() << " / " << usage->limit()
+              << (usage->needs_rekey() ? " (rekey!)" : "") << "\n";
+}
+
+// =======================================================
+// CASE 6: sweep
+//   16 B .. 1 GB (x4 steps), encrypt/decrypt, with/without 32 B AAD, for
+//   the per-call functions, GcmSession seal/open and AES.py (through
+//   AESBench.py on the same key and plaintext). Writes JSON for tracking
+//   regressions between releases.
+// =======================================================
+struct SweepResult {
+    std::string impl;
+    std::string op;
+    std::size_t aad = 0;
+    std::size_t size = 0;
+    std::size_t iterations = 0;
+    double ns_per_op = 0;
+    double gb_per_s = 0;
+    double cycles_per_byte = -1;  // < 0: not available
+    double p50_ns = 0;
+    double p99_ns = 0;
+};
+
+// TSC ticks per ns, measured against steady_clock. 0 if there is no TSC.
+static double tsc_per_ns() {
+#if defined(__x86_64__) || defined(__i386__)
+    auto t0 = Clock::now();
+    auto c0 = __rdtsc();
+    while (Clock::now() - t0 < std::chrono::milliseconds(100)) {}
+    auto c1 = __rdtsc();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    return static_cast<double>(c1 - c0) / ns;
+#else
+    return 0.0;
+#endif
+}
+
+static std::size_t sweep_iterations(std::size_t size) {
+    return std::clamp<std::size_t>((256ULL << 20) / std::max<std::size_t>(size, 1), 5, 20000);
+}
+
+template <typename Op>
+static SweepResult sweep_measure(const char* impl, const char* op, std::size_t aad, std::size_t size,
+                                 double tsc, Op fn) {
+    const std::size_t iters = sweep_iterations(size);
+    std::vector<double> samples(iters);
+    fn();  // warm-up
+    for (auto& ns : samples) {
+        auto t0 = Clock::now();
+        fn();
+        ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    }
+
+    SweepResult r{impl, op, aad, size, iters};
+    double total = 0;
+    for (double ns : samples) total += ns;
+    r.ns_per_op = total / static_cast<double>(iters);
+    r.gb_per_s = static_cast<double>(size) / r.ns_per_op;
+    if (tsc > 0) r.cycles_per_byte = r.ns_per_op * tsc / static_cast<double>(size);
+
+    std::sort(samples.begin(), samples.end());
+    r.p50_ns = samples[iters / 2];
+    r.p99_ns = samples[std::min(iters - 1, iters * 99 / 100)];
+    return r;
+}
+
+static std::string sweep_json(const SweepResult& r) {
+    std::ostringstream os;
+    os << std::setprecision(6)
+       << "{\"impl\":\"" << r.impl << "\",\"op\":\"" << r.op << "\",\"aad\":" << r.aad
+       << ",\"size\":" << r.size << ",\"iterations\":" << r.iterations
+       << ",\"ns_per_op\":" << r.ns_per_op << ",\"gb_per_s\":" << r.gb_per_s
+       << ",\"cycles_per_byte\":";
+    if (r.cycles_per_byte < 0) os << "null";
+    else os << r.cycles_per_byte;
+    os << ",\"p50_ns\":" << r.p50_ns << ",\"p99_ns\":" << r.p99_ns << "}";
+    return os.str();
+}
+
+static void sweep_print(const SweepResult& r) {
+    std::cout << std::left << std::setw(14) << r.impl << std::setw(9) << r.op
+              << std::right << std::setw(5) << r.aad << std::setw(9) << format_size(r.size)
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << r.ns_per_op
+              << std::setprecision(3) << std::setw(9) << r.gb_per_s
+              << std::setprecision(2) << std::setw(9) << r.cycles_per_byte
+              << std::setprecision(0) << std::setw(12) << r.p50_ns << std::setw(12) << r.p99_ns << "\n";
+    std::cout.unsetf(std::ios::fixed);
+}
+
+// Runs AESBench.py on the same key || plaintext and returns its JSON list
+// (without brackets), or an empty string if Python is unavailable. The input
+// holds key material, so it lives in a private mkstemp() file under $TMPDIR
+// that is unlinked as soon as Python is done, and Python is started with
+// posix_spawnp (no shell, so the script path is never parsed).
+static std::string sweep_python(const std::string& script, const std::vector<unsigned char>& key,
+                                const std::vector<unsigned char>& data, std::size_t aad,
+                                const std::vector<std::size_t>& sizes, std::string& error) {
+    const char* tmpdir = std::getenv("TMPDIR");
+    std::string input = std::string(tmpdir && *tmpdir ? tmpdir : "/tmp") + "/aes_bench_input.XXXXXX";
+    const int fd = ::mkstemp(input.data());
+    throwIf(fd < 0, "mkstemp failed for the AESBench.py input");
+    struct Unlink {
+        const std::string& path;
+        ~Unlink() { ::unlink(path.c_str()); }
+    } unlink_input{input};
+    {
+        bool written = true;
+        for (const auto* buf : {&key, &data}) {
+            for (std::size_t off = 0; written && off < buf->size();) {
+                const ssize_t n = ::write(fd, buf->data() + off, buf->size() - off);
+                written = n > 0;
+                off += written ? static_cast<std::size_t>(n) : 0;
+            }
+        }
+        written = ::close(fd) == 0 && written;
+        throwIf(!written, "Cannot write the AESBench.py input");
+    }
+
+    std::vector<std::string> args = {"python3", script, input, std::to_string(aad)};
+    for (std::size_t size : sizes) args.push_back(std::to_string(size) + ":" + std::to_string(sweep_iterations(size)));
+    std::vector<char*> argv;
+    for (auto& a : args) argv.push_back(a.data());
+    argv.push_back(nullptr);
+
+    int pipe_fds[2];
+    throwIf(::pipe(pipe_fds) != 0, "pipe failed");
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipe_fds[0]);
+    posix_spawn_file_actions_addclose(&actions, pipe_fds[1]);
+
+    std::cout.flush();
+    pid_t pid = -1;
+    const int spawn_rc = ::posix_spawnp(&pid, "python3", &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(pipe_fds[1]);
+
+    std::string out;
+    if (spawn_rc == 0) {
+        char buf[4096];
+        ssize_t n;
+        while ((n = ::read(pipe_fds[0], buf, sizeof buf)) > 0) out.append(buf, static_cast<std::size_t>(n));
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            error = "python exited with status " + std::to_string(WEXITSTATUS(status)) +
+                    " (is `cryptography` installed?)";
+            out.clear();
+        }
+    } else {
+        error = std::string("cannot start python3: ") + std::strerror(spawn_rc);
+    }
+    ::close(pipe_fds[0]);
+
+    if (out.size() >= 2 && out.front() == '[' && out.back() == ']') return out.substr(1, out.size() - 2);
+    if (error.empty()) error = "unexpected output from " + script;
+    return {};
+}
+
+static void bench_sweep(std::size_t max_size, const std::string& json_path, const std::string& script) {
+    std::vector<std::size_t> sizes;
+    for (std::size_t s = 16; s <= max_size; s *= 4) sizes.push_back(s);
+
+    auto key = random_bytes(32);
+    auto data = random_bytes(sizes.back());
+    const double tsc = tsc_per_ns();
+    const std::size_t kAad = 32;
+
+    std::cout << std::left << std::setw(14) << "impl" << std::setw(9) << "op"
+              << std::right << std::setw(5) << "aad" << std::setw(9) << "size"
+              << std::setw(14) << "ns/op" << std::setw(9) << "GB/s" << std::setw(9) << "c/B"
+              << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns" << "\n";
+
+    std::vector<SweepResult> results;
+    auto add = [&](SweepResult r) {
+        sweep_print(r);
+        results.push_back(std::move(r));
+    };
+
+    GcmSession session(key);
+    for (std::size_t aad_len : {std::size_t{0}, kAad}) {
+        std::vector<unsigned char> aad(aad_len, 0);
+        for (std::size_t size : sizes) {
+            std::vector<unsigned char> pt(data.begin(), data.begin() + size);
+
+            auto enc = aes256_gcm_encrypt(key, pt, aad);
+            add(sweep_measure("cpp-per-call", "encrypt", aad_len, size, tsc,
+                              [&] { keep(aes256_gcm_encrypt(key, pt, aad)); }));
+            add(sweep_measure("cpp-per-call", "decrypt", aad_len, size, tsc,
+                              [&] { keep(aes256_gcm_decrypt(key, enc.nonce, enc.ciphertext, enc.tag, aad)); }));
+            enc = {};
+
+            // The last seal() leaves a valid message in `wire` for open().
+            std::vector<unsigned char> wire(size + kGcmPackedOverhead), back(size);
+            add(sweep_measure("cpp-session", "encrypt", aad_len, size, tsc,
+                              [&] { keep(session.seal(pt, wire, aad)); }));
+            add(sweep_measure("cpp-session", "decrypt", aad_len, size, tsc,
+                              [&] { keep(session.open(wire, back, aad)); }));
+        }
+    }
+
+    std::string python_json, python_error;
+    if (script != "none") {
+        std::vector<std::size_t> py_sizes;
+        for (std::size_t s : sizes) if (s <= (256ULL << 20)) py_sizes.push_back(s);  // Python copies a lot
+        std::string part0 = sweep_python(script, key, data, 0, py_sizes, python_error);
+        std::string part1 = python_error.empty() ? sweep_python(script, key, data, kAad, py_sizes, python_error) : "";
+        if (python_error.empty()) {
+            python_json = part0 + "," + part1;
+            std::cout << "python: AES.py results for " << py_sizes.size() << " sizes x 2 ops x 2 AAD (JSON only)\n";
+        }
+        else std::cout << "python: skipped (" << python_error << ")\n";
+    }
+
+    std::ofstream js(json_path);
+    js << "{\"meta\":{\"openssl\":\"" << OpenSSL_version(OPENSSL_VERSION) << "\""
+       << ",\"tsc_ghz\":" << std::setprecision(4) << tsc << ",\"hw_threads\":" << std::thread::hardware_concurrency()
+       << ",\"python\":" << (python_json.empty() ? "\"" + (script == "none" ? std::string("disabled") : python_error) + "\""
+                                                 : std::string("\"ok\""))
+       << "},\"results\":[";
+    for (std::size_t i = 0; i < results.size(); ++i) js << (i ? "," : "") << sweep_json(results[i]);
+    if (!python_json.empty()) js << "," << python_json;
+    js << "]}\n";
+    throwIf(!js, "Cannot write JSON output");
+    std::cout << "wrote " << json_path << "\n";
+}
+
+static void print_usage(const char* prog) {
+    std::cout
+        << "Usage:\n"
+        << "  " << prog << " stream [chunk=1MB] [size...]\n"
+        << "  " << prog << " session [count=200000] [size...]\n"
+        << "  " << prog << " parallel [size=1GB] [segment=1MB] [threads...]\n"
+        << "  " << prog << " batch [records=262144] [record=128] [batch...]\n"
+        << "  " << prog << " nonce [messages/thread=1000000] [threads...]\n"
+        << "  " << prog << " sweep [max=1GB] [json=aes_bench.json] [python=AESBench.py|none]\n";
+}
+
+int main(int argc, char** argv) {
+    std::string mode = (argc > 1) ? argv[1] : "stream";
+
+    try {
+        if (mode == "stream") {
+            std::size_t chunk = (argc > 2) ? parse_size(argv[2]) : 1024 * 1024;
+            throwIf(chunk == 0, "chunk must be > 0");
+
+            std::vector<std::size_t> sizes;
+            for (int i = 3; i < argc; ++i) sizes.push_back(parse_size(argv[i]));
+            if (sizes.empty()) {
+                // Up to 50GB: RSS must stay at the chunk buffers however far we go.
+                for (std::size_t mb : {1, 16, 256, 1024, 4096, 16384, 51200}) sizes.push_back(mb * 1024 * 1024);
+            }
+            bench_stream(chunk, sizes);
+        } else if (mode == "session") {
+            std::size_t count = (argc > 2) ? std::stoull(argv[2]) : 200000;
+
+            std::vector<std::size_t> sizes;
+            for (int i = 3; i < argc; ++i) sizes.push_back(parse_size(argv[i]));
+            if (sizes.empty()) sizes = {64, 128, 256, 512};
+            bench_session(count, sizes);
+        } else if (mode == "parallel") {
+            std::size_t size = (argc > 2) ? parse_size(argv[2]) : 1024ULL * 1024 * 1024;
+            std::size_t segment = (argc > 3) ? parse_size(argv[3]) : kStreamDefaultSegment;
+
+            std::vector<unsigned> threads;
+            for (int i = 4; i < argc; ++i) threads.push_back(static_cast<unsigned>(std::stoul(argv[i])));
+            if (threads.empty()) {
+                unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+                for (unsigned t = 1; t < hw; t *= 2) threads.push_back(t);
+                threads.push_back(hw);
+            }
+            bench_parallel(size, segment, threads);
+        } else if (mode == "batch") {
+            std::size_t total = (argc > 2) ? std::stoull(argv[2]) : 262144;
+            std::size_t record = (argc > 3) ? parse_size(argv[3]) : 128;
+
+            std::vector<std::size_t> batches;
+            for (int i = 4; i < argc; ++i) batches.push_back(std::stoull(argv[i]));
+            if (batches.empty()) batches = {1, 16, 256, 4096};
+            bench_batch(total, record, batches);
+        } else if (mode == "nonce") {
+            std::size_t per_thread = (argc > 2) ? std::stoull(argv[2]) : 1000000;
+
+            std::vector<unsigned> threads;
+            for (int i = 3; i < argc; ++i) threads.push_back(static_cast<unsigned>(std::stoul(argv[i])));
+            if (threads.empty()) {
+                unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+                for (unsigned t = 1; t < hw; t *= 2) threads.push_back(t);
+                threads.push_back(hw);
+            }
+            bench_nonce(per_thread, threads);
+        } else if (mode == "sweep") {
+            std::size_t max_size = (argc > 2) ? parse_size(argv[2]) : 1024ULL * 1024 * 1024;
+            std::string json_path = (argc > 3) ? argv[3] : "aes_bench.json";
+            std::string script = (argc > 4) ? argv[4] : "AESBench.py";
+            throwIf(max_size < 16, "max must be >= 16B");
+            bench_sweep(max_size, json_path, script);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+"""Python side of `./aes_bench sweep`: times AES.py on the same key/inputs.
+
+Usage (normally started by AESBench.cpp):
+    python3 AESBench.py <input-file> <aad-bytes> <size>:<iterations> ...
+
+The input file holds the 32-byte key followed by the plaintext bytes; each
+size uses the first `size` plaintext bytes. Prints one JSON list to stdout.
+"""
+import json
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from AES import aes_gcm_encrypt, aes_gcm_decrypt  # noqa: E402
+
+
+def percentile(samples, q):
+    ordered = sorted(samples)
+    return ordered[min(len(ordered) - 1, int(q * len(ordered)))]
+
+
+def record(op, aad_len, size, samples):
+    total = sum(samples)
+    ns = total / len(samples)
+    return {
+        "impl": "python-AES.py",
+        "op": op,
+        "aad": aad_len,
+        "size": size,
+        "iterations": len(samples),
+        "ns_per_op": ns,
+        "gb_per_s": size / ns if ns else 0.0,
+        "cycles_per_byte": None,
+        "p50_ns": percentile(samples, 0.50),
+        "p99_ns": percentile(samples, 0.99),
+    }
+
+
+def main():
+    path, aad_len, jobs = sys.argv[1], int(sys.argv[2]), sys.argv[3:]
+    with open(path, "rb") as f:
+        key = f.read(32)
+        data = f.read()
+    aad = bytes(aad_len)
+
+    results = []
+    for job in jobs:
+        size, iterations = (int(x) for x in job.split(":"))
+        pt = data[:size]
+
+        enc_samples, dec_samples = [], []
+        nonce, ct = aes_gcm_encrypt(key, pt, aad)
+        for _ in range(iterations):
+            t0 = time.perf_counter_ns()
+            nonce, ct = aes_gcm_encrypt(key, pt, aad)
+            enc_samples.append(time.perf_counter_ns() - t0)
+        for _ in range(iterations):
+            t0 = time.perf_counter_ns()
+            aes_gcm_decrypt(key, nonce, ct, aad)
+            dec_samples.append(time.perf_counter_ns() - t0)
+
+        results.append(record("encrypt", aad_len, size, enc_samples))
+        results.append(record("decrypt", aad_len, size, dec_samples))
+
+    json.dump(results, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
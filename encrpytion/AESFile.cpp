@@ -0,0 +1,497 @@
+#include "AES.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* Usage
+./aes_file keygen key.bin
+./aes_file encrypt key.bin backup.tar backup.tar.enc
+./aes_file decrypt key.bin backup.tar.enc backup.tar --threads=8
+./aes_file encrypt key.bin /dev/nvme0n1 disk.enc --input=direct --segment=4MB
+*/
+
+// Build (example):
+//   g++ -std=c++20 -O2 -Wall AESFile.cpp -lcrypto -pthread -o aes_file
+//
+// Output uses the segmented STREAM format from AES.hpp, so a file written
+// here opens with aes256_gcm_decrypt_parallel() and vice versa.
+//
+// Pipeline:
+//   reader --work--> N encryptors --done--> writer --free--> reader
+// A fixed set of jobs (buffers) circulates through bounded queues, so
+// memory stays at depth * segment no matter how large the input is.
+
+using Clock = std::chrono::steady_clock;
+
+enum class InputMode { Read, Mmap, Direct };
+
+struct Options {
+    bool encrypt = true;
+    std::string key_path;
+    std::string in_path;
+    std::string out_path;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t segment = 4 * 1024 * 1024;
+    std::size_t depth = 0;  // 0 = 2 * threads + 2
+    InputMode input = InputMode::Read;
+};
+
+// Parse strings like: "4MB", "512KB", "100B"
+static std::size_t parse_size(std::string s) {
+    for (char& c : s) c = std::toupper(static_cast<unsigned char>(c));
+
+    std::size_t i = 0;
+    while (i < s.size() && (std::isdigit(static_cast<unsigned char>(s[i])) || s[i] == '.')) i++;
+    if (i == 0) throw std::runtime_error("Size must start with a number (e.g., 4MB)");
+
+    double value = std::stod(s.substr(0, i));
+    std::string unit = s.substr(i);
+
+    std::size_t mult = 1;
+    if (unit.empty() || unit == "B") mult = 1;
+    else if (unit == "KB") mult = 1024ULL;
+    else if (unit == "MB") mult = 1024ULL * 1024;
+    else if (unit == "GB") mult = 1024ULL * 1024 * 1024;
+    else throw std::runtime_error("Unknown unit. Use B/KB/MB/GB (e.g., 4MB)");
+
+    return static_cast<std::size_t>(value * static_cast<double>(mult));
+}
+
+// =======================================================
+// Bounded blocking queue (close() wakes everyone; pop() then drains)
+// =======================================================
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        not_full_.wait(lock, [&] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(value));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Returns false once the queue is closed and empty.
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        not_empty_.wait(lock, [&] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        out = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<T> items_;
+    std::size_t capacity_;
+    bool closed_ = false;
+};
+
+// =======================================================
+// Jobs: one input buffer (page aligned for O_DIRECT) + one output buffer
+// =======================================================
+constexpr std::size_t kPage = 4096;
+
+struct FreeDeleter {
+    void operator()(unsigned char* p) const noexcept { std::free(p); }
+};
+
+struct Job {
+    std::size_t index = 0;
+    bool last = false;
+    std::unique_ptr<unsigned char, FreeDeleter> in_buf;
+    std::span<const unsigned char> in;  // into in_buf or into the mmap
+    std::vector<unsigned char> out;
+    std::size_t out_len = 0;
+};
+
+// Busy time per stage, added once per job.
+struct StageTimes {
+    std::atomic<std::int64_t> reader_ns{0};
+    std::atomic<std::int64_t> crypto_ns{0};
+    std::atomic<std::int64_t> writer_ns{0};
+};
+
+static std::int64_t elapsed_ns(Clock::time_point t0) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+}
+
+struct Fd {
+    int fd = -1;
+    explicit Fd(int f) : fd(f) {}
+    ~Fd() { if (fd >= 0) ::close(fd); }
+    Fd(const Fd&) = delete;
+    Fd& operator=(const Fd&) = delete;
+};
+
+static void pread_all(int fd, unsigned char* dst, std::size_t len, off_t off) {
+    std::size_t done = 0;
+    while (done < len) {
+        ssize_t r = ::pread(fd, dst + done, len - done, off + static_cast<off_t>(done));
+        if (r < 0 && errno == EINTR) continue;
+        throwIf(r < 0, "pread failed");
+        throwIf(r == 0, "Unexpected end of input");
+        done += static_cast<std::size_t>(r);
+    }
+}
+
+static void write_all(int fd, const unsigned char* src, std::size_t len) {
+    std::size_t done = 0;
+    while (done < len) {
+        ssize_t w = ::write(fd, src + done, len - done);
+        if (w < 0 && errno == EINTR) continue;
+        throwIf(w < 0, "write failed");
+        done += static_cast<std::size_t>(w);
+    }
+}
+
+// Reads [off, off + len) into the job. O_DIRECT needs page-aligned offsets,
+// lengths and buffers, so it reads the aligned superset and points inside it.
+class InputReader {
+public:
+    InputReader(const std::string& path, InputMode mode) : mode_(mode), fd_(-1) {
+        int flags = O_RDONLY;
+        if (mode_ == InputMode::Direct) flags |= O_DIRECT;
+        fd_.fd = ::open(path.c_str(), flags);
+        throwIf(fd_.fd < 0, "Cannot open input (O_DIRECT needs a filesystem that supports it)");
+
+        off_t end = ::lseek(fd_.fd, 0, SEEK_END);  // also works for block devices
+        throwIf(end < 0, "Input must be seekable (regular file or block device)");
+        size_ = static_cast<std::size_t>(end);
+
+        if (mode_ == InputMode::Mmap && size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_.fd, 0);
+            throwIf(p == MAP_FAILED, "mmap failed");
+            map_ = static_cast<unsigned char*>(p);
+            ::madvise(map_, size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    ~InputReader() {
+        if (map_) ::munmap(map_, size_);
+    }
+
+    std::size_t size() const noexcept { return size_; }
+
+    // Largest buffer any read() may need for a span of `len` bytes.
+    static std::size_t buffer_bytes(std::size_t len) { return (len + 2 * kPage + kPage - 1) / kPage * kPage; }
+
+    void read(Job& job, std::size_t off, std::size_t len) {
+        if (len == 0) {
+            job.in = {};
+            return;
+        }
+        switch (mode_) {
+        case InputMode::Mmap: {
+            job.in = std::span<const unsigned char>(map_ + off, len);
+            // Fault the pages in here so I/O time is charged to the reader.
+            volatile unsigned char sink = 0;
+            for (std::size_t i = 0; i < len; i += kPage) sink = sink + job.in[i];
+            sink = sink + job.in[len - 1];
+            break;
+        }
+        case InputMode::Direct: {
+            const std::size_t start = off / kPage * kPage;
+            const std::size_t stop = std::min((off + len + kPage - 1) / kPage * kPage,
+                                              (size_ + kPage - 1) / kPage * kPage);
+            std::size_t done = 0;
+            while (done < stop - start) {
+                ssize_t r = ::pread(fd_.fd, job.in_buf.get() + done, stop - start - done,
+                                    static_cast<off_t>(start + done));
+                if (r < 0 && errno == EINTR) continue;
+                throwIf(r < 0, "pread (O_DIRECT) failed");
+                if (r == 0) break;  // EOF inside the last page
+                done += static_cast<std::size_t>(r);
+            }
+            throwIf(start + done < off + len, "Unexpected end of input");
+            job.in = std::span<const unsigned char>(job.in_buf.get() + (off - start), len);
+            break;
+        }
+        case InputMode::Read:
+            pread_all(fd_.fd, job.in_buf.get(), len, static_cast<off_t>(off));
+            job.in = std::span<const unsigned char>(job.in_buf.get(), len);
+            break;
+        }
+    }
+
+private:
+    InputMode mode_;
+    Fd fd_;
+    std::size_t size_ = 0;
+    unsigned char* map_ = nullptr;
+};
+
+// =======================================================
+// The pipeline
+// =======================================================
+static int run(const Options& opt) {
+    std::vector<unsigned char> key(32);
+    {
+        std::ifstream kf(opt.key_path, std::ios::binary);
+        throwIf(!kf, "Cannot open key file");
+        kf.read(reinterpret_cast<char*>(key.data()), (std::streamsize)key.size());
+        throwIf(kf.gcount() != 32 || kf.peek() != EOF, "Key file must hold exactly 32 bytes");
+    }
+
+    InputReader input(opt.in_path, opt.input);
+
+    // Header and segment layout
+    std::vector<unsigned char> header_aad;
+    StreamLayout layout{};
+    std::size_t body_off = 0;
+    if (opt.encrypt) {
+        header_aad = stream_make_header(opt.segment);
+        layout = stream_layout_for_plaintext(input.size(), opt.segment);
+    } else {
+        throwIf(input.size() < kStreamHeaderBytes, "Input too short for an encrypted stream");
+        Job probe;
+        probe.in_buf.reset(static_cast<unsigned char*>(std::aligned_alloc(kPage, InputReader::buffer_bytes(kStreamHeaderBytes))));
+        throwIf(!probe.in_buf, "aligned_alloc failed");
+        input.read(probe, 0, kStreamHeaderBytes);
+        header_aad.assign(probe.in.begin(), probe.in.end());
+        layout = stream_layout_for_sealed(input.size() - kStreamHeaderBytes, stream_header_segment_size(header_aad));
+        body_off = kStreamHeaderBytes;
+    }
+    const StreamKey stream_key(key, header_aad);
+    const std::size_t seg = layout.segment_size;
+    const std::size_t in_stride = opt.encrypt ? seg : seg + 16;
+    const std::size_t depth = opt.depth ? opt.depth : 2 * opt.threads + 2;
+
+    Fd out(::open(opt.out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600));
+    throwIf(out.fd < 0, "Cannot open output");
+    struct stat out_st{};
+    ::fstat(out.fd, &out_st);
+
+    BoundedQueue<Job*> free_q(depth), work_q(depth), done_q(depth);
+    std::vector<Job> jobs(depth);
+    for (auto& j : jobs) {
+        j.in_buf.reset(static_cast<unsigned char*>(std::aligned_alloc(kPage, InputReader::buffer_bytes(seg + 16))));
+        throwIf(!j.in_buf, "aligned_alloc failed");
+        j.out.resize(seg + 16);
+        free_q.push(&j);
+    }
+
+    StageTimes times;
+    std::atomic<bool> failed{false};
+    std::mutex err_mtx;
+    std::string error;
+    auto fail = [&](const std::exception& e) {
+        {
+            std::lock_guard<std::mutex> lock(err_mtx);
+            if (error.empty()) error = e.what();
+        }
+        failed.store(true);
+        free_q.close();
+        work_q.close();
+        done_q.close();
+    };
+
+    auto t_start = Clock::now();
+
+    std::thread reader([&] {
+        try {
+            for (std::size_t i = 0; i < layout.segments && !failed.load(); ++i) {
+                Job* j = nullptr;
+                if (!free_q.pop(j)) return;
+                auto t0 = Clock::now();
+                j->index = i;
+                j->last = (i + 1 == layout.segments);
+                const std::size_t plain = j->last ? layout.last_plain : seg;
+                input.read(*j, body_off + i * in_stride, opt.encrypt ? plain : plain + 16);
+                times.reader_ns += elapsed_ns(t0);
+                if (!work_q.push(j)) return;
+            }
+            work_q.close();
+        } catch (const std::exception& e) {
+            fail(e);
+        }
+    });
+
+    std::atomic<unsigned> crypto_left{opt.threads};
+    std::vector<std::thread> crypto;
+    for (unsigned t = 0; t < opt.threads; ++t) {
+        crypto.emplace_back([&] {
+            try {
+                GcmSession session(stream_key.bytes());
+                Job* j = nullptr;
+                while (work_q.pop(j)) {
+                    auto t0 = Clock::now();
+                    if (opt.encrypt) {
+                        j->out_len = j->in.size() + 16;
+                        stream_seal_segment(session, header_aad, j->index, j->last, j->in,
+                                            std::span(j->out).first(j->out_len));
+                    } else {
+                        j->out_len = j->in.size() - 16;
+                        stream_open_segment(session, header_aad, j->index, j->last, j->in, j->out);
+                    }
+                    times.crypto_ns += elapsed_ns(t0);
+                    if (!done_q.push(j)) return;
+                }
+                if (crypto_left.fetch_sub(1) == 1) done_q.close();
+            } catch (const std::exception& e) {
+                fail(e);
+            }
+        });
+    }
+
+    std::thread writer([&] {
+        try {
+            auto t0 = Clock::now();
+            if (opt.encrypt) write_all(out.fd, header_aad.data(), kStreamHeaderBytes);
+            times.writer_ns += elapsed_ns(t0);
+
+            // Jobs finish out of order; at most `depth` are in flight, so a
+            // ring indexed by segment % depth is enough to restore order.
+            std::vector<Job*> pending(depth, nullptr);
+            std::size_t next = 0;
+            Job* j = nullptr;
+            while (next < layout.segments && done_q.pop(j)) {
+                pending[j->index % depth] = j;
+                while (next < layout.segments && pending[next % depth] &&
+                       pending[next % depth]->index == next) {
+                    Job* ready = pending[next % depth];
+                    pending[next % depth] = nullptr;
+                    t0 = Clock::now();
+                    write_all(out.fd, ready->out.data(), ready->out_len);
+                    times.writer_ns += elapsed_ns(t0);
+                    next++;
+                    free_q.push(ready);
+                }
+            }
+            throwIf(next != layout.segments && !failed.load(), "Pipeline stopped early");
+            t0 = Clock::now();
+            throwIf(::fsync(out.fd) != 0 && S_ISREG(out_st.st_mode), "fsync failed");
+            times.writer_ns += elapsed_ns(t0);
+        } catch (const std::exception& e) {
+            fail(e);
+        }
+    });
+
+    reader.join();
+    for (auto& t : crypto) t.join();
+    writer.join();
+    const double wall = std::chrono::duration<double>(Clock::now() - t_start).count();
+
+    if (failed.load()) {
+        // Never leave a partially decrypted (or encrypted) file behind.
+        if (S_ISREG(out_st.st_mode)) ::unlink(opt.out_path.c_str());
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    const double reader_s = times.reader_ns.load() / 1e9;
+    const double crypto_s = times.crypto_ns.load() / 1e9 / opt.threads;
+    const double writer_s = times.writer_ns.load() / 1e9;
+    const double gb = static_cast<double>(input.size()) / 1e9;
+
+    std::cout << (opt.encrypt ? "Encrypted " : "Decrypted ") << input.size() << " bytes in "
+              << layout.segments << " segments of " << seg << " B, " << opt.threads
+              << " threads, depth " << depth << "\n";
+    std::cout << std::fixed << std::setprecision(3)
+              << "wall " << wall << " s, " << gb / wall << " GB/s\n\n"
+              << std::left << std::setw(16) << "stage" << std::right << std::setw(12) << "busy(s)"
+              << std::setw(10) << "util" << "\n";
+    auto row = [&](const char* name, double busy) {
+        std::cout << std::left << std::setw(16) << name << std::right << std::setw(12) << busy
+                  << std::setw(9) << std::setprecision(1) << 100.0 * busy / wall << "%\n"
+                  << std::setprecision(3);
+    };
+    row("reader", reader_s);
+    row(opt.encrypt ? "encrypt (avg)" : "decrypt (avg)", crypto_s);
+    row("writer", writer_s);
+
+    const char* bottleneck = "reader";
+    if (crypto_s >= reader_s && crypto_s >= writer_s) bottleneck = opt.encrypt ? "encrypt" : "decrypt";
+    else if (writer_s >= reader_s) bottleneck = "writer";
+    std::cout << "bottleneck: " << bottleneck << "\n";
+    return 0;
+}
+
+static void print_usage(const char* prog) {
+    std::cout
+        << "Usage:\n"
+        << "  " << prog << " keygen <key-file>\n"
+        << "  " << prog << " encrypt|decrypt <key-file> <in> <out> [options]\n"
+        << "Options:\n"
+        << "  --threads=N              encryptor threads (default: all cores)\n"
+        << "  --segment=4MB            segment size (encrypt only; stored in the header)\n"
+        << "  --depth=K                buffers in flight (default: 2 * threads + 2)\n"
+        << "  --input=read|mmap|direct read(), mmap + MADV_SEQUENTIAL, or O_DIRECT\n";
+}
+
+int main(int argc, char** argv) {
+    try {
+        std::string cmd = (argc > 1) ? argv[1] : "";
+
+        if (cmd == "keygen" && argc == 3) {
+            unsigned char key[32];
+            throwIf(RAND_bytes(key, sizeof key) != 1, "RAND_bytes failed");
+            Fd fd(::open(argv[2], O_WRONLY | O_CREAT | O_EXCL, 0600));
+            throwIf(fd.fd < 0, "Cannot create key file (already exists?)");
+            write_all(fd.fd, key, sizeof key);
+            std::cout << "Wrote 32-byte key to " << argv[2] << "\n";
+            return 0;
+        }
+
+        if ((cmd != "encrypt" && cmd != "decrypt") || argc < 5) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        Options opt;
+        opt.encrypt = (cmd == "encrypt");
+        opt.key_path = argv[2];
+        opt.in_path = argv[3];
+        opt.out_path = argv[4];
+
+        for (int i = 5; i < argc; ++i) {
+            std::string a = argv[i];
+            auto value = [&](const char* name) { return a.substr(std::strlen(name)); };
+            if (a.rfind("--threads=", 0) == 0) opt.threads = static_cast<unsigned>(std::stoul(value("--threads=")));
+            else if (a.rfind("--segment=", 0) == 0) opt.segment = parse_size(value("--segment="));
+            else if (a.rfind("--depth=", 0) == 0) opt.depth = std::stoull(value("--depth="));
+            else if (a == "--input=read") opt.input = InputMode::Read;
+            else if (a == "--input=mmap") opt.input = InputMode::Mmap;
+            else if (a == "--input=direct") opt.input = InputMode::Direct;
+            else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+        throwIf(opt.threads == 0, "threads must be > 0");
+        throwIf(opt.depth != 0 && opt.depth < 2, "depth must be >= 2");
+
+        return run(opt);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
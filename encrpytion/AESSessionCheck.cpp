@@ -0,0 +1,119 @@
+#include "AES.hpp"
+
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// =======================================================
+// Session checks
+//   - Cache eviction: holds a session from gcm_session_cache() while more
+//     than kMaxSessions other key IDs go through the same cache, then keeps
+//     using it. The held session must survive its eviction (run under ASan
+//     to be sure).
+//   - fork(): parent and child keep sealing with the sequences they had
+//     before the fork; their next nonces must differ.
+//   Exits non-zero on failure.
+//
+// Build/run (example):
+//   g++ -std=c++20 -O1 -g -fsanitize=address AESSessionCheck.cpp -lcrypto && ./a.out
+// =======================================================
+
+int main() {
+    unsigned char key[32];
+    throwIf(RAND_bytes(key, sizeof key) != 1, "RAND_bytes failed");
+    const std::vector<unsigned char> pt = {'h', 'e', 'l', 'l', 'o'};
+
+    auto& cache = gcm_session_cache();
+    auto held = cache.get("held", key);
+
+    bool ok = true;
+    for (std::size_t i = 0; i < GcmSessionCache::kMaxSessions + 1; ++i) {
+        cache.get("other-" + std::to_string(i), key);
+    }
+    ok = ok && cache.size() == GcmSessionCache::kMaxSessions;
+    std::cout << "cache size after " << GcmSessionCache::kMaxSessions + 1 << " other IDs: " << cache.size()
+              << (cache.size() == GcmSessionCache::kMaxSessions ? "  OK" : "  FAIL") << "\n";
+
+    // "held" was the least recently used, so it is gone from the cache...
+    auto fresh = cache.get("held", key);
+    const bool evicted = fresh != held;
+    ok = ok && evicted;
+    std::cout << "held session evicted from cache: " << (evicted ? "yes  OK" : "no  FAIL") << "\n";
+
+    // ...but the caller's copy still works, and both interoperate.
+    auto enc = held->encrypt(pt);
+    const bool round_trip = fresh->decrypt(enc.nonce, enc.ciphertext, enc.tag) == pt;
+    ok = ok && round_trip;
+    std::cout << "held session still seals after eviction: " << (round_trip ? "OK" : "FAIL") << "\n";
+
+    // A recently used ID is not the one evicted.
+    cache.get("other-" + std::to_string(GcmSessionCache::kMaxSessions), key);
+    auto recent = cache.get("recent", key);
+    for (std::size_t i = 0; i < GcmSessionCache::kMaxSessions - 1; ++i) {
+        cache.get("recent", key);
+        cache.get("more-" + std::to_string(i), key);
+    }
+    const bool kept = cache.get("recent", key) == recent;
+    ok = ok && kept;
+    std::cout << "recently used session kept: " << (kept ? "OK" : "FAIL") << "\n";
+
+    // Per-call functions: one-shot seals step the thread's sequence instead
+    // of starting a new one, and a key ID counts against that key's budget.
+    {
+        unsigned char a[5 + kGcmPackedOverhead], b[5 + kGcmPackedOverhead];
+        aes256_gcm_seal(key, pt, a);
+        aes256_gcm_seal(key, pt, b);
+        const bool same_sequence = std::equal(a, a + 8, b) && !std::equal(a, a + 12, b);
+        ok = ok && same_sequence;
+        std::cout << "one-shot seals share the thread sequence: " << (same_sequence ? "OK" : "FAIL") << "\n";
+
+        const std::vector<unsigned char> k(key, key + sizeof key);
+        aes256_gcm_encrypt(k, pt, {}, "per-call");
+        aes256_gcm_seal(key, pt, a, {}, "per-call");
+        const bool budgeted = gcm_key_usage("per-call")->used() > 0;
+        ok = ok && budgeted;
+        std::cout << "per-call key ID draws from its budget: " << (budgeted ? "OK" : "FAIL") << "\n";
+    }
+
+    // fork(): both the thread-local sequence (aes256_gcm_encrypt) and a
+    // session's own sequence have been used, so both hold a live prefix.
+    {
+        const std::vector<unsigned char> k(key, key + sizeof key);
+        GcmSession session(key);
+        aes256_gcm_encrypt(k, pt);
+        session.encrypt(pt);
+
+        int fds[2];
+        throwIf(::pipe(fds) != 0, "pipe failed");
+        const pid_t pid = ::fork();
+        throwIf(pid < 0, "fork failed");
+        auto nonces = [&] {
+            auto a = aes256_gcm_encrypt(k, pt).nonce;
+            auto b = session.encrypt(pt).nonce;
+            a.insert(a.end(), b.begin(), b.end());
+            return a;
+        };
+        if (pid == 0) {
+            auto n = nonces();
+            const bool written = ::write(fds[1], n.data(), n.size()) == (ssize_t)n.size();
+            ::_exit(written ? 0 : 1);
+        }
+        ::close(fds[1]);
+        auto mine = nonces();
+        std::vector<unsigned char> child(mine.size());
+        const bool read_ok = ::read(fds[0], child.data(), child.size()) == (ssize_t)child.size();
+        ::close(fds[0]);
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+
+        const bool thread_differs = read_ok && !std::equal(mine.begin(), mine.begin() + 12, child.begin());
+        const bool session_differs = read_ok && !std::equal(mine.begin() + 12, mine.end(), child.begin() + 12);
+        ok = ok && thread_differs && session_differs;
+        std::cout << "fork: thread-local nonces differ: " << (thread_differs ? "OK" : "FAIL")
+                  << "  session nonces differ: " << (session_differs ? "OK" : "FAIL") << "\n";
+    }
+
+    std::cout << (ok ? "PASS: session checks\n" : "FAIL: session checks\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,522 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define XLAB_SIMD_X86 1
+#endif
+
+// =======================================================
+// SIMD array kernels with runtime dispatch
+//   evolutionOfArrayHandling.cpp fills 5-element arrays with loops, iota
+//   and ranges. These kernels do the same kind of work (plus sum,
+//   min/max, transform, prefix sum, filter) on int32 arrays of any size,
+//   with SSE4.2 / AVX2 / AVX-512 bodies picked once from CPUID.
+//
+//   Every kernel takes std::span, so std::array<int, N>, std::vector<int>
+//   and C arrays all pass straight in:
+//
+//     std::vector<int> v(1 << 20);
+//     simd::iota(v, 0);
+//     auto total = simd::sum(v);
+//
+//   Outputs must be at least as long as their input (std::invalid_argument
+//   otherwise). Integer overflow wraps, except sum, which accumulates in
+//   64 bits. simd::set_level() pins a lower level, e.g. for benchmarks.
+//
+// Build (example, no -march needed; each body carries its own target):
+//   g++ -std=c++20 -O2 -Wall simdKernelsBench.cpp
+// =======================================================
+
+namespace simd {
+
+enum class Level { Scalar, Sse42, Avx2, Avx512 };
+
+inline const char* name(Level l) {
+    switch (l) {
+    case Level::Scalar: return "scalar";
+    case Level::Sse42: return "sse4.2";
+    case Level::Avx2: return "avx2";
+    case Level::Avx512: return "avx512";
+    }
+    return "?";
+}
+
+struct MinMax {
+    std::int32_t min;
+    std::int32_t max;
+};
+
+// One entry per kernel; `n` is the input length, outputs were checked.
+struct Kernels {
+    Level level;
+    void (*iota)(std::int32_t* out, std::size_t n, std::int32_t start);
+    std::int64_t (*sum)(const std::int32_t* in, std::size_t n);
+    MinMax (*minmax)(const std::int32_t* in, std::size_t n);
+    void (*affine)(const std::int32_t* in, std::int32_t* out, std::size_t n, std::int32_t mul, std::int32_t add);
+    void (*inclusive_scan)(const std::int32_t* in, std::int32_t* out, std::size_t n);
+    std::size_t (*filter_greater)(const std::int32_t* in, std::int32_t* out, std::size_t n, std::int32_t threshold);
+};
+
+namespace detail {
+
+// Wrapping int32 arithmetic without signed-overflow UB.
+inline std::int32_t wrap_add(std::int32_t a, std::int32_t b) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b));
+}
+inline std::int32_t wrap_mul(std::int32_t a, std::int32_t b) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) * static_cast<std::uint32_t>(b));
+}
+
+// =======================================================
+// Scalar (also the tail of every vector body)
+// =======================================================
+namespace scalar {
+
+inline void iota(std::int32_t* out, std::size_t n, std::int32_t start) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = wrap_add(start, static_cast<std::int32_t>(i));
+}
+
+inline std::int64_t sum(const std::int32_t* in, std::size_t n) {
+    std::int64_t s = 0;
+    for (std::size_t i = 0; i < n; ++i) s += in[i];
+    return s;
+}
+
+inline MinMax minmax(const std::int32_t* in, std::size_t n) {
+    MinMax r{std::numeric_limits<std::int32_t>::max(), std::numeric_limits<std::int32_t>::min()};
+    for (std::size_t i = 0; i < n; ++i) {
+        r.min = std::min(r.min, in[i]);
+        r.max = std::max(r.max, in[i]);
+    }
+    return r;
+}
+
+inline void affine(const std::int32_t* in, std::int32_t* out, std::size_t n, std::int32_t mul, std::int32_t add) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = wrap_add(wrap_mul(in[i], mul), add);
+}
+
+inline void inclusive_scan(const std::int32_t* in, std::int32_t* out, std::size_t n, std::int32_t carry = 0) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = carry = wrap_add(carry, in[i]);
+}
+
+inline std::size_t filter_greater(const std::int32_t* in, std::int32_t* out, std::size_t n, std::int32_t threshold) {
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        out[k] = in[i];
+        k += in[i] > threshold;   // branch-free: always store, advance on match
+    }
+    return k;
+}
+
+} // namespace scalar
+
+#if XLAB_SIMD_X86
+
+// Shuffle tables for compaction: entry m moves the lanes whose bit is set
+// in m to the front. Built once; 16 x 16 bytes for SSE, 256 x 8 ints for AVX2.
+inline const std::array<std::array<std::uint8_t, 16>, 16>& sse_compact_table() {
+    static const auto table = [] {
+        std::array<std::array<std::uint8_t, 16>, 16> t{};
+        for (int m = 0; m < 16; ++m) {
+            int k = 0;
+            for (int lane = 0; lane < 4; ++lane) {
+                if (!(m & (1 << lane))) continue;
+                for (int b = 0; b < 4; ++b) t[m][k * 4 + b] = static_cast<std::uint8_t>(lane * 4 + b);
+                ++k;
+            }
+            for (; k < 4; ++k)
+                for (int b = 0; b < 4; ++b) t[m][k * 4 + b] = 0x80;
+        }
+        return t;
+    }();
+    return table;
+}
+
+inline const std::array<std::array<std::int32_t, 8>, 256>& avx2_compact_table() {
+    static const auto table = [] {
+        std::array<std::array<std::int32_t, 8>, 256> t{};
+        for (int m = 0; m < 256; ++m) {
+            int k = 0;
+            for (int lane = 0; lane < 8; ++lane)
+                if (m & (1 << lane)) t[m][k++] = lane;
+        }
+        return t;
+    }();
+    return table;
+}
+
+// =======================================================
+// SSE4.2 (4 lanes)
+// =======================================================
+namespace sse42 {
+
+__attribute__((target("sse4.2"))) inline void iota(std::int32_t* out, std::size_t n, std::int32_t start) {
+    __m128i v = _mm_add_epi32(_mm_set1_epi32(start), _mm_setr_epi32(0, 1, 2, 3));
+    const __m128i step = _mm_set1_epi32(4);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+        v = _mm_add_epi32(v, step);
+    }
+    scalar::iota(out + i, n - i, wrap_add(start, static_cast<std::int32_t>(i)));
+}
+
+__attribute__((target("sse4.2"))) inline std::int64_t sum(const std::int32_t* in, std::size_t n) {
+    __m128i a0 = _mm_setzero_si128(), a1 = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        a0 = _mm_add_epi64(a0, _mm_cvtepi32_epi64(x));
+        a1 = _mm_add_epi64(a1, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+    }
+    const __m128i a = _mm_add_epi64(a0, a1);
+    return _mm_cvtsi128_si64(a) + _mm_extract_epi64(a, 1) + scalar::sum(in + i, n - i);
+}
+
+__attribute__((target("sse4.2"))) inline MinMax minmax(const std::int32_t* in, std::size_t n) {
+    __m128i lo = _mm_set1_epi32(std::numeric_limits<std::int32_t>::max());
+    __m128i hi = _mm_set1_epi32(std::numeric_limits<std::int32_t>::min());
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        lo = _mm_min_epi32(lo, x);
+        hi = _mm_max_epi32(hi, x);
+    }
+    alignas(16) std::int32_t l[4], h[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(l), lo);
+    _mm_store_si128(reinterpret_cast<__m128i*>(h), hi);
+    MinMax r = scalar::minmax(in + i, n - i);
+    for (int k = 0; k < 4; ++k) {
+        r.min = std::min(r.min, l[k]);
+        r.max = std::max(r.max, h[k]);
+    }
+    return r;
+}
+
+__attribute__((target("sse4.2"))) inline void affine(const std::int32_t* in, std::int32_t* out, std::size_t n,
+                                                     std::int32_t mul, std::int32_t add) {
+    const __m128i m = _mm_set1_epi32(mul), a = _mm_set1_epi32(add);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi32(_mm_mullo_epi32(x, m), a));
+    }
+    scalar::affine(in + i, out + i, n - i, mul, add);
+}
+
+__attribute__((target("sse4.2"))) inline void inclusive_scan(const std::int32_t* in, std::int32_t* out, std::size_t n) {
+    __m128i carry = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), x);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+    }
+    scalar::inclusive_scan(in + i, out + i, n - i, _mm_cvtsi128_si32(carry));
+}
+
+__attribute__((target("sse4.2"))) inline std::size_t filter_greater(const std::int32_t* in, std::int32_t* out,
+                                                                    std::size_t n, std::int32_t threshold) {
+    const auto& table = sse_compact_table();
+    const __m128i t = _mm_set1_epi32(threshold);
+    std::size_t i = 0, k = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const int m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, t)));
+        const __m128i shuf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table[m].data()));
+        // k <= i, so the full 4-lane store stays inside out[0, n).
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_shuffle_epi8(x, shuf));
+        k += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(m)));
+    }
+    return k + scalar::filter_greater(in + i, out + k, n - i, threshold);
+}
+
+} // namespace sse42
+
+// =======================================================
+// AVX2 (8 lanes)
+// =======================================================
+namespace avx2 {
+
+__attribute__((target("avx2"))) inline void iota(std::int32_t* out, std::size_t n, std::int32_t start) {
+    __m256i v = _mm256_add_epi32(_mm256_set1_epi32(start), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i step = _mm256_set1_epi32(8);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+        v = _mm256_add_epi32(v, step);
+    }
+    scalar::iota(out + i, n - i, wrap_add(start, static_cast<std::int32_t>(i)));
+}
+
+__attribute__((target("avx2"))) inline std::int64_t sum(const std::int32_t* in, std::size_t n) {
+    __m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        a0 = _mm256_add_epi64(a0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        a1 = _mm256_add_epi64(a1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+    }
+    const __m256i a = _mm256_add_epi64(a0, a1);
+    const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1) + scalar::sum(in + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline MinMax minmax(const std::int32_t* in, std::size_t n) {
+    __m256i lo = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::max());
+    __m256i hi = _mm256_set1_epi32(std::numeric_limits<std::int32_t>::min());
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        lo = _mm256_min_epi32(lo, x);
+        hi = _mm256_max_epi32(hi, x);
+    }
+    alignas(32) std::int32_t l[8], h[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(l), lo);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(h), hi);
+    MinMax r = scalar::minmax(in + i, n - i);
+    for (int k = 0; k < 8; ++k) {
+        r.min = std::min(r.min, l[k]);
+        r.max = std::max(r.max, h[k]);
+    }
+    return r;
+}
+
+__attribute__((target("avx2"))) inline void affine(const std::int32_t* in, std::int32_t* out, std::size_t n,
+                                                   std::int32_t mul, std::int32_t add) {
+    const __m256i m = _mm256_set1_epi32(mul), a = _mm256_set1_epi32(add);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_add_epi32(_mm256_mullo_epi32(x, m), a));
+    }
+    scalar::affine(in + i, out + i, n - i, mul, add);
+}
+
+__attribute__((target("avx2"))) inline void inclusive_scan(const std::int32_t* in, std::int32_t* out, std::size_t n) {
+    __m256i carry = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        // Scan each 128-bit half, then add the low half's total to the high half.
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+        const __m256i low_total = _mm256_shuffle_epi32(x, 0xFF);
+        x = _mm256_add_epi32(x, _mm256_permute2x128_si256(low_total, low_total, 0x08));
+        x = _mm256_add_epi32(x, carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+        carry = _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+    }
+    scalar::inclusive_scan(in + i, out + i, n - i, _mm256_cvtsi256_si32(carry));
+}
+
+__attribute__((target("avx2,popcnt"))) inline std::size_t filter_greater(const std::int32_t* in, std::int32_t* out,
+                                                                         std::size_t n, std::int32_t threshold) {
+    const auto& table = avx2_compact_table();
+    const __m256i t = _mm256_set1_epi32(threshold);
+    std::size_t i = 0, k = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const int m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, t)));
+        const __m256i perm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(table[m].data()));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), _mm256_permutevar8x32_epi32(x, perm));
+        k += static_cast<std::size_t>(_mm_popcnt_u32(static_cast<unsigned>(m)));
+    }
+    return k + scalar::filter_greater(in + i, out + k, n - i, threshold);
+}
+
+} // namespace avx2
+
+// =======================================================
+// AVX-512F (16 lanes; masked ops make the tails vector code too)
+// =======================================================
+// GCC 12's AVX-512 intrinsics trip -Wmaybe-uninitialized on their own
+// _mm512_undefined_* placeholders (GCC PR 105593).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+namespace avx512 {
+
+__attribute__((target("avx512f"))) inline __mmask16 tail_mask(std::size_t left) {
+    return static_cast<__mmask16>(left >= 16 ? 0xFFFF : (1u << left) - 1);
+}
+
+__attribute__((target("avx512f"))) inline void iota(std::int32_t* out, std::size_t n, std::int32_t start) {
+    __m512i v = _mm512_add_epi32(_mm512_set1_epi32(start),
+                                 _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    const __m512i step = _mm512_set1_epi32(16);
+    for (std::size_t i = 0; i < n; i += 16) {
+        _mm512_mask_storeu_epi32(out + i, tail_mask(n - i), v);
+        v = _mm512_add_epi32(v, step);
+    }
+}
+
+__attribute__((target("avx512f"))) inline std::int64_t sum(const std::int32_t* in, std::size_t n) {
+    __m512i a0 = _mm512_setzero_si512(), a1 = _mm512_setzero_si512();
+    for (std::size_t i = 0; i < n; i += 16) {
+        const __m512i x = _mm512_maskz_loadu_epi32(tail_mask(n - i), in + i);
+        a0 = _mm512_add_epi64(a0, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)));
+        a1 = _mm512_add_epi64(a1, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1)));
+    }
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(a0, a1));
+}
+
+__attribute__((target("avx512f"))) inline MinMax minmax(const std::int32_t* in, std::size_t n) {
+    const __m512i max = _mm512_set1_epi32(std::numeric_limits<std::int32_t>::max());
+    const __m512i min = _mm512_set1_epi32(std::numeric_limits<std::int32_t>::min());
+    __m512i lo = max, hi = min;
+    for (std::size_t i = 0; i < n; i += 16) {
+        const __mmask16 m = tail_mask(n - i);
+        lo = _mm512_min_epi32(lo, _mm512_mask_loadu_epi32(max, m, in + i));
+        hi = _mm512_max_epi32(hi, _mm512_mask_loadu_epi32(min, m, in + i));
+    }
+    return {_mm512_reduce_min_epi32(lo), _mm512_reduce_max_epi32(hi)};
+}
+
+__attribute__((target("avx512f"))) inline void affine(const std::int32_t* in, std::int32_t* out, std::size_t n,
+                                                      std::int32_t mul, std::int32_t add) {
+    const __m512i m = _mm512_set1_epi32(mul), a = _mm512_set1_epi32(add);
+    for (std::size_t i = 0; i < n; i += 16) {
+        const __mmask16 k = tail_mask(n - i);
+        const __m512i x = _mm512_maskz_loadu_epi32(k, in + i);
+        _mm512_mask_storeu_epi32(out + i, k, _mm512_add_epi32(_mm512_mullo_epi32(x, m), a));
+    }
+}
+
+__attribute__((target("avx512f"))) inline void inclusive_scan(const std::int32_t* in, std::int32_t* out, std::size_t n) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i last = _mm512_set1_epi32(15);
+    __m512i carry = zero;
+    for (std::size_t i = 0; i < n; i += 16) {
+        const __mmask16 k = tail_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi32(k, in + i);
+        // valignd shifts across the whole register: x + (x << 1, 2, 4, 8 lanes).
+        x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 15));
+        x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 14));
+        x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 12));
+        x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 8));
+        x = _mm512_add_epi32(x, carry);
+        _mm512_mask_storeu_epi32(out + i, k, x);
+        carry = _mm512_permutexvar_epi32(last, x);
+    }
+}
+
+__attribute__((target("avx512f,popcnt"))) inline std::size_t filter_greater(const std::int32_t* in, std::int32_t* out,
+                                                                            std::size_t n, std::int32_t threshold) {
+    const __m512i t = _mm512_set1_epi32(threshold);
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < n; i += 16) {
+        const __m512i x = _mm512_maskz_loadu_epi32(tail_mask(n - i), in + i);
+        const __mmask16 m = _mm512_mask_cmpgt_epi32_mask(tail_mask(n - i), x, t);
+        _mm512_mask_compressstoreu_epi32(out + k, m, x);
+        k += static_cast<std::size_t>(_mm_popcnt_u32(m));
+    }
+    return k;
+}
+
+} // namespace avx512
+#pragma GCC diagnostic pop
+
+#endif // XLAB_SIMD_X86
+
+inline std::size_t level_index(Level l) { return static_cast<std::size_t>(l); }
+
+inline const std::array<Kernels, 4>& tables() {
+    static const std::array<Kernels, 4> t = {
+        Kernels{Level::Scalar, scalar::iota, scalar::sum, scalar::minmax, scalar::affine,
+                [](const std::int32_t* in, std::int32_t* out, std::size_t n) { scalar::inclusive_scan(in, out, n); },
+                scalar::filter_greater},
+#if XLAB_SIMD_X86
+        Kernels{Level::Sse42, sse42::iota, sse42::sum, sse42::minmax, sse42::affine, sse42::inclusive_scan,
+                sse42::filter_greater},
+        Kernels{Level::Avx2, avx2::iota, avx2::sum, avx2::minmax, avx2::affine, avx2::inclusive_scan,
+                avx2::filter_greater},
+        Kernels{Level::Avx512, avx512::iota, avx512::sum, avx512::minmax, avx512::affine, avx512::inclusive_scan,
+                avx512::filter_greater},
+#endif
+    };
+    return t;
+}
+
+inline void require(bool ok, const char* what) {
+    if (!ok) throw std::invalid_argument(what);
+}
+
+} // namespace detail
+
+// Best level this CPU (and OS, via the compiler's checks) supports.
+inline Level detect() {
+#if XLAB_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Level::Avx512;
+    if (__builtin_cpu_supports("avx2")) return Level::Avx2;
+    if (__builtin_cpu_supports("sse4.2")) return Level::Sse42;
+#endif
+    return Level::Scalar;
+}
+
+namespace detail {
+
+inline std::atomic<const Kernels*>& active_slot() {
+    static std::atomic<const Kernels*> slot{&tables()[level_index(detect())]};
+    return slot;
+}
+
+} // namespace detail
+
+inline const Kernels& kernels() { return *detail::active_slot().load(std::memory_order_relaxed); }
+
+inline Level level() { return kernels().level; }
+
+// Never goes above detect(); returns the level actually in use.
+inline Level set_level(Level want) {
+    const Level l = std::min(want, detect());
+    detail::active_slot().store(&detail::tables()[detail::level_index(l)], std::memory_order_relaxed);
+    return l;
+}
+
+// =======================================================
+// Public kernels
+// =======================================================
+inline void iota(std::span<std::int32_t> out, std::int32_t start) { kernels().iota(out.data(), out.size(), start); }
+
+inline std::int64_t sum(std::span<const std::int32_t> in) { return kernels().sum(in.data(), in.size()); }
+
+inline MinMax minmax(std::span<const std::int32_t> in) {
+    detail::require(!in.empty(), "simd::minmax: empty input");
+    return kernels().minmax(in.data(), in.size());
+}
+
+// out[i] = in[i] * mul + add
+inline void affine(std::span<const std::int32_t> in, std::span<std::int32_t> out, std::int32_t mul, std::int32_t add) {
+    detail::require(out.size() >= in.size(), "simd::affine: output shorter than input");
+    kernels().affine(in.data(), out.data(), in.size(), mul, add);
+}
+
+// out[i] = in[0] + ... + in[i]; in and out may be the same array.
+inline void inclusive_scan(std::span<const std::int32_t> in, std::span<std::int32_t> out) {
+    detail::require(out.size() >= in.size(), "simd::inclusive_scan: output shorter than input");
+    kernels().inclusive_scan(in.data(), out.data(), in.size());
+}
+
+// Copies the elements > threshold to the front of out, in order; returns
+// how many. out must not overlap in.
+inline std::size_t filter_greater(std::span<const std::int32_t> in, std::span<std::int32_t> out, std::int32_t threshold) {
+    detail::require(out.size() >= in.size(), "simd::filter_greater: output shorter than input");
+    return kernels().filter_greater(in.data(), out.data(), in.size(), threshold);
+}
+
+} // namespace simd
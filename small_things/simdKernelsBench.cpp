@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "simdKernels.hpp"
+
+/* Usage
+./app              # every kernel, 4 KB (L1) .. 256 MB (DRAM) inputs
+./app 67108864     # largest input in bytes (at least 4096)
+
+Every level is first checked against the scalar bodies; a mismatch exits 1.
+
+Build: g++ -std=c++20 -O2 simdKernelsBench.cpp -o app
+*/
+
+using Clock = std::chrono::steady_clock;
+
+template <class T>
+static void do_not_optimize(const T& v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+struct Variant {
+    std::string name;
+    std::function<void(std::span<const int>, std::span<int>)> run;
+};
+
+// GB/s for one variant at one size. `bytes_per_elem` is what the kernel
+// streams (e.g. 8 for read + write).
+static double gbps(const Variant& v, std::span<const int> in, std::span<int> out, double bytes_per_elem) {
+    const std::size_t n = in.size();
+    const std::size_t reps = std::max<std::size_t>(1, (std::size_t(1) << 28) / (n * sizeof(int)));
+    v.run(in, out);   // warm-up, faults pages in
+    auto t0 = Clock::now();
+    for (std::size_t r = 0; r < reps; ++r) v.run(in, out);
+    const double s = std::chrono::duration<double>(Clock::now() - t0).count();
+    return bytes_per_elem * double(n) * double(reps) / s / 1e9;
+}
+
+static void table(const char* title, double bytes_per_elem, const std::vector<Variant>& variants,
+                  const std::vector<std::size_t>& sizes, std::span<const int> input, std::span<int> output) {
+    std::printf("\n[%s] GB/s\n  %-22s", title, "variant");
+    for (std::size_t n : sizes) {
+        const std::size_t kb = n * sizeof(int) / 1024;
+        if (kb < 1024) std::printf(" %7zuK", kb);
+        else std::printf(" %7zuM", kb / 1024);
+    }
+    std::printf("\n");
+    for (const Variant& v : variants) {
+        std::printf("  %-22s", v.name.c_str());
+        for (std::size_t n : sizes) std::printf(" %8.1f", gbps(v, input.first(n), output.first(n), bytes_per_elem));
+        std::printf("\n");
+    }
+}
+
+// The simd:: rows, one per level this CPU has.
+template <class F>
+static void add_levels(std::vector<Variant>& v, F f) {
+    for (int l = 0; l <= static_cast<int>(simd::detect()); ++l) {
+        const auto level = static_cast<simd::Level>(l);
+        v.push_back({std::string("simd ") + simd::name(level), [=](std::span<const int> in, std::span<int> out) {
+                         simd::set_level(level);
+                         f(in, out);
+                     }});
+    }
+}
+
+static void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+        std::exit(1);
+    }
+}
+
+// Every vector body against the scalar one, on lengths that cover the
+// vector width tails (0..67) plus one long run, with values over the whole
+// int32 range so wrapping arithmetic is exercised too.
+static void verify_levels() {
+    std::mt19937 rng(7);
+    std::vector<std::size_t> lengths(68);
+    std::iota(lengths.begin(), lengths.end(), 0);
+    lengths.push_back(100'003);
+
+    for (std::size_t n : lengths) {
+        std::vector<int> in(n), small(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            in[i] = static_cast<int>(rng());
+            small[i] = static_cast<int>(rng() % 2001) - 1000;
+        }
+
+        simd::set_level(simd::Level::Scalar);
+        std::vector<int> iota_ref(n), affine_ref(n), scan_ref(n), filter_ref(n);
+        simd::iota(iota_ref, std::numeric_limits<int>::max() - 5);
+        const auto sum_ref = simd::sum(in);
+        const auto mm_ref = n ? simd::minmax(in) : simd::MinMax{};
+        simd::affine(in, affine_ref, -7, 3);
+        simd::inclusive_scan(in, scan_ref);
+        const auto kept_ref = simd::filter_greater(small, filter_ref, 0);
+        filter_ref.resize(kept_ref);
+
+        for (int l = 1; l <= static_cast<int>(simd::detect()); ++l) {
+            const auto level = static_cast<simd::Level>(l);
+            simd::set_level(level);
+            const std::string at = std::string(" (") + simd::name(level) + ", n=" + std::to_string(n) + ")";
+            std::vector<int> out(n);
+
+            simd::iota(out, std::numeric_limits<int>::max() - 5);
+            check(out == iota_ref, "iota" + at);
+            check(simd::sum(in) == sum_ref, "sum" + at);
+            if (n) {
+                const auto mm = simd::minmax(in);
+                check(mm.min == mm_ref.min && mm.max == mm_ref.max, "minmax" + at);
+            }
+            simd::affine(in, out, -7, 3);
+            check(out == affine_ref, "affine" + at);
+            simd::inclusive_scan(in, out);
+            check(out == scan_ref, "inclusive_scan" + at);
+            out = in;
+            simd::inclusive_scan(out, out);
+            check(out == scan_ref, "inclusive_scan in place" + at);
+            const auto kept = simd::filter_greater(small, out, 0);
+            out.resize(kept);
+            check(out == filter_ref, "filter_greater" + at);
+        }
+    }
+    simd::set_level(simd::detect());
+}
+
+int main(int argc, char** argv) {
+    const std::size_t max_bytes = argc > 1 ? std::stoull(argv[1]) : (std::size_t(256) << 20);
+    if (max_bytes < 4096) {
+        std::fprintf(stderr, "largest input must be at least 4096 bytes\n");
+        return 1;
+    }
+    std::vector<std::size_t> sizes;
+    for (std::size_t bytes = 4096; bytes <= max_bytes; bytes *= 8) sizes.push_back(bytes / sizeof(int));
+    if (sizes.back() < max_bytes / sizeof(int)) sizes.push_back(max_bytes / sizeof(int));   // always end at max
+
+    std::vector<int> input(sizes.back()), output(sizes.back());
+    std::mt19937 rng(42);
+    for (int& x : input) x = static_cast<int>(rng() % 2001) - 1000;
+
+    std::printf("detected: %s\n", simd::name(simd::detect()));
+    verify_levels();
+    std::printf("verified: every level matches scalar\n");
+
+    {
+        std::vector<Variant> v = {
+            {"index loop", [](auto, std::span<int> out) { for (std::size_t i = 0; i < out.size(); ++i) out[i] = int(i); }},
+            {"std::iota", [](auto, std::span<int> out) { std::iota(out.begin(), out.end(), 0); }},
+            {"views::iota + copy", [](auto, std::span<int> out) {
+                 std::ranges::copy(std::views::iota(0, int(out.size())), out.begin());
+             }},
+        };
+        add_levels(v, [](auto, std::span<int> out) { simd::iota(out, 0); });
+        table("iota", 4, v, sizes, input, output);
+    }
+    {
+        std::vector<Variant> v = {
+            {"index loop", [](std::span<const int> in, auto) {
+                 long long s = 0;
+                 for (std::size_t i = 0; i < in.size(); ++i) s += in[i];
+                 do_not_optimize(s);
+             }},
+            {"std::accumulate", [](std::span<const int> in, auto) {
+                 auto s = std::accumulate(in.begin(), in.end(), 0LL);
+                 do_not_optimize(s);
+             }},
+        };
+        add_levels(v, [](std::span<const int> in, auto) {
+            auto s = simd::sum(in);
+            do_not_optimize(s);
+        });
+        table("sum", 4, v, sizes, input, output);
+    }
+    {
+        std::vector<Variant> v = {
+            {"std::ranges::minmax", [](std::span<const int> in, auto) {
+                 auto r = std::ranges::minmax(in);
+                 do_not_optimize(r);
+             }},
+        };
+        add_levels(v, [](std::span<const int> in, auto) {
+            auto r = simd::minmax(in);
+            do_not_optimize(r);
+        });
+        table("min/max", 4, v, sizes, input, output);
+    }
+    {
+        std::vector<Variant> v = {
+            {"std::ranges::transform", [](std::span<const int> in, std::span<int> out) {
+                 std::ranges::transform(in, out.begin(), [](int x) { return x * 3 + 7; });
+             }},
+        };
+        add_levels(v, [](std::span<const int> in, std::span<int> out) { simd::affine(in, out, 3, 7); });
+        table("transform x*3+7", 8, v, sizes, input, output);
+    }
+    {
+        std::vector<Variant> v = {
+            {"std::inclusive_scan", [](std::span<const int> in, std::span<int> out) {
+                 std::inclusive_scan(in.begin(), in.end(), out.begin());
+             }},
+        };
+        add_levels(v, [](std::span<const int> in, std::span<int> out) { simd::inclusive_scan(in, out); });
+        table("prefix sum", 8, v, sizes, input, output);
+    }
+    {
+        // Threshold 0: about half the elements pass, the worst case for branches.
+        std::vector<Variant> v = {
+            {"std::ranges::copy_if", [](std::span<const int> in, std::span<int> out) {
+                 auto r = std::ranges::copy_if(in, out.begin(), [](int x) { return x > 0; });
+                 do_not_optimize(r);
+             }},
+        };
+        add_levels(v, [](std::span<const int> in, std::span<int> out) {
+            auto k = simd::filter_greater(in, out, 0);
+            do_not_optimize(k);
+        });
+        table("filter x > 0", 8, v, sizes, input, output);
+    }
+    return 0;
+}